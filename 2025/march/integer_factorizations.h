@@ -1,14 +1,116 @@
 #ifndef INTEGER_FACTORIZATIONS_H
 #define INTEGER_FACTORIZATIONS_H
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <ranges>
 #include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 
+// Process-wide smallest-prime-factor sieve. It grows on demand up to `kMaxSieve`, which is above the square root of any
+// 32-bit number, so larger numbers are factored by trial division over the sieved primes.
+class prime_sieve
+{
+public:
+    using num_type = uint32_t;
+
+    struct prime_power
+    {
+        num_type prime;
+        uint32_t exponent;
+    };
+
+    // Prime factors of n in ascending order (empty for n < 2).
+    static std::vector<prime_power> prime_signature(num_type n)
+    {
+        std::vector<prime_power> signature;
+        if(n < 2)
+            return signature;
+
+        auto const append = [&](num_type const p)
+        {
+            if(!signature.empty() && signature.back().prime == p)
+                ++signature.back().exponent;
+            else
+                signature.push_back({p, 1});
+        };
+
+        std::lock_guard lock(mtx_);
+        grow_(std::min<size_t>(n, kMaxSieve));
+
+        for(auto const p: primes_)
+        {
+            if(n < spf_.size() || uint64_t{p} * p > n)
+                break;
+            for(; n % p == 0; n /= p)
+                append(p);
+        }
+
+        if(n >= spf_.size())
+        {
+            // No prime factor up to sqrt(n) is left.
+            append(n);
+            n = 1;
+        }
+
+        for(; n > 1; n /= spf_[n])
+            append(spf_[n]);
+
+        return signature;
+    }
+
+private:
+    prime_sieve()  = delete;
+    ~prime_sieve() = default;
+
+    prime_sieve(prime_sieve const&)            = delete;
+    prime_sieve& operator=(prime_sieve const&) = delete;
+
+    static constexpr size_t kMaxSieve = size_t{1} << 20;
+
+    // Linear sieve over [0, limit], at least doubling the previous size to keep regrowth amortised.
+    static void grow_(size_t const limit)
+    {
+        if(limit < spf_.size())
+            return;
+
+        auto const size = std::min(std::max(limit + 1, 2 * spf_.size()), kMaxSieve + 1);
+        spf_.assign(size, 0);
+        primes_.clear();
+
+        for(size_t i = 2; i < size; ++i)
+        {
+            if(spf_[i] == 0)
+            {
+                spf_[i] = i;
+                primes_.push_back(i);
+            }
+            for(auto const p: primes_)
+            {
+                if(p > spf_[i] || i * p >= size)
+                    break;
+                spf_[i * p] = p;
+            }
+        }
+    }
+
+    static inline std::mutex            mtx_{};
+    static inline std::vector<num_type> spf_{};
+    static inline std::vector<num_type> primes_{};
+};
+
+
 class integer_factorizations
 {
 public:
@@ -19,7 +121,7 @@ public:
         uint32_t count;
     };
 
-    using value_type             = std::span<factor>;
+    using value_type             = std::span<factor const>;
     using reference              = value_type&;
     using const_reference        = value_type const&;
     using size_type              = size_t;
@@ -29,16 +131,39 @@ public:
     using reverse_iterator       = std::vector<value_type>::reverse_iterator;
     using const_reverse_iterator = std::vector<value_type>::const_reverse_iterator;
 
-    constexpr explicit integer_factorizations(num_type n, num_type cutoff = std::numeric_limits<num_type>::max())
+    explicit integer_factorizations(num_type n, num_type cutoff = std::numeric_limits<num_type>::max())
         : factors_{},
           factorizations_{},
           number_{n}
     {
-        if(n < 0)
+        if(n == 0)
             throw std::invalid_argument{"integer_factorizations: n must be positive"};
         compute_factorizations_(n, cutoff);
     }
 
+    // Factorizations are spans into `factors_`, so a copy has to re-point them at its own storage.
+    constexpr integer_factorizations(integer_factorizations const& other)
+        : factors_{other.factors_},
+          factorizations_{},
+          number_{other.number_}
+    {
+        rebind_factorizations_(other);
+    }
+
+    constexpr integer_factorizations& operator=(integer_factorizations const& other)
+    {
+        if(this != &other)
+        {
+            factors_ = other.factors_;
+            number_  = other.number_;
+            rebind_factorizations_(other);
+        }
+        return *this;
+    }
+
+    constexpr integer_factorizations(integer_factorizations&&) noexcept            = default;
+    constexpr integer_factorizations& operator=(integer_factorizations&&) noexcept = default;
+
     constexpr num_type number() const noexcept { return number_; }
 
     [[nodiscard]] constexpr iterator       begin() noexcept { return factorizations_.begin(); }
@@ -57,76 +182,195 @@ public:
     const_reference operator[](size_type i) const noexcept { return factorizations_[i]; }
 
 private:
-    std::vector<factor>            factors_;
-    std::vector<std::span<factor>> factorizations_;
-    num_type                       number_;
+    std::vector<factor>     factors_;
+    std::vector<value_type> factorizations_;
+    num_type                number_;
 
-    constexpr void compute_factorizations_(num_type n, num_type cutoff)
+    constexpr void rebind_factorizations_(integer_factorizations const& other)
+    {
+        factorizations_.clear();
+        factorizations_.reserve(other.factorizations_.size());
+        for(auto const& f: other.factorizations_)
+            factorizations_.emplace_back(factors_.data() + (f.data() - other.factors_.data()), f.size());
+    }
+
+    // Multiplicative partitions of n into non-decreasing factors no larger than `cutoff`, in lexicographic order. Only
+    // divisors of n can appear, so they are built from the prime signature instead of scanning every integer up to n.
+    void compute_factorizations_(num_type n, num_type cutoff)
     {
         if(n < 2)
         {
             factors_        = {factor{1, 1}};
-            factorizations_ = {std::span<factor>{factors_}};
+            factorizations_ = {value_type{factors_}};
             return;
         }
 
         factors_.clear();
         factorizations_.clear();
 
-        auto const trial_n = static_cast<size_t>(std::sqrt(n)) + 1;
+        std::vector<num_type> divisors{1};
+        for(auto const [p, exponent]: prime_sieve::prime_signature(n))
+        {
+            auto const prev_size = divisors.size();
+            num_type   power     = 1;
+            for(uint32_t e = 0; e < exponent; ++e)
+            {
+                power *= p;
+                for(size_t i = 0; i < prev_size; ++i)
+                    divisors.push_back(divisors[i] * power);
+            }
+        }
+        std::ranges::sort(divisors);
 
         std::vector<size_t> ends;
-        ends.reserve(trial_n);
         ends.assign(1, 0);
 
         std::vector<num_type> curr_factors;
-        curr_factors.reserve(trial_n);
+        curr_factors.reserve(std::bit_width(n));
 
-        find_next_(n, 2, cutoff, curr_factors, ends);
+        // divisors[0] == 1, so factors start at divisors[1].
+        find_next_(n, divisors, 1, cutoff, curr_factors, ends);
 
-        for(auto i = 1; i < ends.size(); ++i)
+        for(size_t i = 1; i < ends.size(); ++i)
             factorizations_.emplace_back(factors_.data() + ends[i - 1], ends[i] - ends[i - 1]);
     }
 
-    constexpr void find_next_(num_type n, num_type start_factor, num_type cutoff_factor,
-                              std::vector<num_type>& curr_factors, std::vector<size_t>& ends)
+    void find_next_(num_type n, std::span<num_type const> divisors, size_t start_idx, num_type cutoff_factor,
+                    std::vector<num_type>& curr_factors, std::vector<size_t>& ends)
     {
-        if(start_factor > cutoff_factor)
-            return;
-
-        if(n < 2)
+        for(auto i = start_idx; i < divisors.size(); ++i)
         {
-            factor f{curr_factors.front(), 0};
-            for(auto&& x: curr_factors)
-            {
-                if(x != f.base)
-                {
-                    factors_.push_back(f);
-                    f = factor{x, 0};
-                }
-                ++f.count;
-            }
-            factors_.push_back(f);
-            ends.push_back(factors_.size());
-            return;
-        }
+            auto const d = divisors[i];
+            if(d > cutoff_factor || uint64_t{d} * d > n)
+                break;
+            if(n % d != 0)
+                continue;
 
-        auto divisors = std::views::iota(start_factor, n + 1) |
-                        std::views::filter([&](auto d) { return d * d <= n && n % d == 0; });
-        for(int d: divisors)
-        {
             curr_factors.push_back(d);
-            find_next_(n / d, d, cutoff_factor, curr_factors, ends);
+            find_next_(n / d, divisors, i, cutoff_factor, curr_factors, ends);
             curr_factors.pop_back();
         }
 
-        if(n >= start_factor)
+        if(n <= cutoff_factor)
         {
             curr_factors.push_back(n);
-            find_next_(1, n, cutoff_factor, curr_factors, ends);
+            push_factorization_(curr_factors, ends);
             curr_factors.pop_back();
         }
     }
+
+    // Appends the run-length encoding of the sorted `curr_factors`.
+    void push_factorization_(std::vector<num_type> const& curr_factors, std::vector<size_t>& ends)
+    {
+        factor f{curr_factors.front(), 0};
+        for(auto&& x: curr_factors)
+        {
+            if(x != f.base)
+            {
+                factors_.push_back(f);
+                f = factor{x, 0};
+            }
+            ++f.count;
+        }
+        factors_.push_back(f);
+        ends.push_back(factors_.size());
+    }
+};
+
+
+// Lazily walks the distinct orderings of one factorization as a sequence of segment lengths. The consumer extends the
+// current prefix with `push` and takes the last factor back with `pop`, so a rejected prefix is never extended and no
+// full ordering is ever materialised. State lives in fixed-size arrays: a 32-bit number has at most 32 prime factors.
+class ordered_factors
+{
+public:
+    using num_type = integer_factorizations::num_type;
+
+    static constexpr size_t kMaxFactors = std::numeric_limits<num_type>::digits;
+
+    constexpr explicit ordered_factors(integer_factorizations::value_type const factors) noexcept
+        : slot_count_{factors.size()}
+    {
+        for(size_t i = 0; i < slot_count_; ++i)
+        {
+            bases_[i]     = factors[i].base;
+            remaining_[i] = factors[i].count;
+            length_ += factors[i].count;
+        }
+    }
+
+    // Number of factors in a complete sequence.
+    constexpr size_t length() const noexcept { return length_; }
+
+    // Number of factors in the current prefix.
+    constexpr size_t depth() const noexcept { return depth_; }
+
+    constexpr bool is_complete() const noexcept { return depth_ == length_; }
+
+    // Slots are the distinct factors; `next_slot` skips the ones already used up by the prefix and returns
+    // `slot_count()` past the last one.
+    constexpr size_t slot_count() const noexcept { return slot_count_; }
+    constexpr size_t first_slot() const noexcept { return next_slot_(0); }
+    constexpr size_t next_slot(size_t const slot) const noexcept { return next_slot_(slot + 1); }
+
+    constexpr num_type base(size_t const slot) const noexcept { return bases_[slot]; }
+
+    constexpr void push(size_t const slot) noexcept
+    {
+        --remaining_[slot];
+        prefix_[depth_++] = static_cast<uint8_t>(slot);
+    }
+
+    constexpr void pop() noexcept { ++remaining_[prefix_[--depth_]]; }
+
+    constexpr auto prefix() const noexcept
+    {
+        return std::span{prefix_}.first(depth_) | std::views::transform([this](auto const slot) { return bases_[slot]; });
+    }
+
+private:
+    std::array<num_type, kMaxFactors> bases_{};
+    std::array<uint32_t, kMaxFactors> remaining_{};
+    std::array<uint8_t, kMaxFactors>  prefix_{};
+    size_t                            slot_count_ = 0;
+    size_t                            length_     = 0;
+    size_t                            depth_      = 0;
+
+    constexpr size_t next_slot_(size_t slot) const noexcept
+    {
+        while(slot < slot_count_ && remaining_[slot] == 0)
+            ++slot;
+        return slot;
+    }
+};
+
+
+// Process-wide memo of factorizations keyed by (n, cutoff), shared by repeated clues, grids and batch runs. Entries are
+// never evicted or changed, so the returned reference stays valid and can be read from any thread.
+class factorization_cache
+{
+public:
+    using num_type = integer_factorizations::num_type;
+
+    static integer_factorizations const& get(num_type const n, num_type const cutoff)
+    {
+        std::lock_guard lock(mtx_);
+
+        auto it = cache_.find({n, cutoff});
+        if(it == cache_.end())
+            it = cache_.emplace(std::pair{n, cutoff}, integer_factorizations(n, cutoff)).first;
+        return it->second;
+    }
+
+private:
+    factorization_cache()  = delete;
+    ~factorization_cache() = default;
+
+    factorization_cache(factorization_cache const&)            = delete;
+    factorization_cache& operator=(factorization_cache const&) = delete;
+
+    static inline std::mutex                                                         mtx_{};
+    static inline std::map<std::pair<num_type, num_type>, integer_factorizations> cache_{};
 };
 
 
@@ -3,10 +3,14 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <initializer_list>
 #include <limits>
 #include <ranges>
 #include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <sys/types.h>
 #include <utility>
 #include <vector>
@@ -73,10 +77,270 @@ constexpr direction direction_after_mirror(mirror_type m, direction dir) noexcep
     return mirror_dir_map[std::to_underlying(m)][std::to_underlying(dir)];
 }
 
+// Cell and boundary storage: a heap vector when the grid length is only known at runtime, an inline array of `Size`
+// elements when it is fixed at compile time.
+template<class T, size_t N, size_t Size>
+using grid_array_t = std::conditional_t<N == std::dynamic_extent, std::vector<T>, std::array<T, Size>>;
+
+template<class Array>
+constexpr Array make_grid_array(size_t const size)
+{
+    if constexpr(std::is_same_v<Array, std::vector<typename Array::value_type>>)
+        return Array(size);
+    else
+        return Array{};
+}
+
+// Grid length, either stored or a compile-time constant that takes no space.
+template<size_t N>
+struct grid_extent
+{
+    constexpr explicit grid_extent(size_t) noexcept {}
+
+    static constexpr size_t value() noexcept { return N; }
+};
+
+template<>
+struct grid_extent<std::dynamic_extent>
+{
+    constexpr explicit grid_extent(size_t const n) noexcept
+        : n_{n}
+    {}
+
+    constexpr size_t value() const noexcept { return n_; }
+
+private:
+    size_t n_;
+};
+
+// One counter per cell, positive for LR and negative for RL, so that paths sharing a mirror can each add and remove it.
+template<size_t N = std::dynamic_extent>
+class mirror_counter_storage
+{
+public:
+    constexpr explicit mirror_counter_storage(size_t const n)
+        : mirrors_(make_grid_array<decltype(mirrors_)>(n * n)),
+          length_{n}
+    {}
+
+    constexpr mirror_type mirror(int const row, int const col) const noexcept
+    {
+        bool const is_LR = mirrors_[to_idx_(row, col)] > 0;
+        bool const is_RL = mirrors_[to_idx_(row, col)] < 0;
+        return static_cast<mirror_type>(std::to_underlying(mirror_type::LR) * is_LR +
+                                        std::to_underlying(mirror_type::RL) * is_RL);
+    }
+
+    constexpr int add(int const row, int const col, mirror_type const m) noexcept
+    {
+        return mirrors_[to_idx_(row, col)] += (m == mirror_type::LR) - (m == mirror_type::RL);
+    }
+
+    constexpr int remove(int const row, int const col, mirror_type const m) noexcept
+    {
+        return mirrors_[to_idx_(row, col)] -= (m == mirror_type::LR) - (m == mirror_type::RL);
+    }
+
+    constexpr bool has_adjacent_mirror(int const row, int const col) const noexcept
+    {
+        static constexpr auto dirs = std::array<std::pair<int, int>, 4>{{{-1, 0}, {0, -1}, {1, 0}, {0, 1}}};
+
+        return std::ranges::any_of(dirs,
+                                   [&](std::pair<int, int> const& dir)
+                                   {
+                                       auto const nr = row + dir.first;
+                                       auto const nc = col + dir.second;
+                                       return in_bounds_(nr, nc) && mirror(nr, nc) != mirror_type::None;
+                                   });
+    }
+
+    // True when none of the `len` cells after (row, col) in direction `dir` holds a mirror. Cells outside the grid are
+    // ignored.
+    constexpr bool is_path_clear(int const row, int const col, direction const dir, int const len) const noexcept
+    {
+        auto const [dr, dc] = direction_to_vector(dir);
+        for(int k = 1; k <= len; ++k)
+        {
+            auto const r = row + k * dr;
+            auto const c = col + k * dc;
+            if(in_bounds_(r, c) && mirror(r, c) != mirror_type::None)
+                return false;
+        }
+        return true;
+    }
+
+    // Steps from (row, col) in direction `dir` to the next mirror, or to the first position outside the grid.
+    constexpr int distance_to_mirror(int const row, int const col, direction const dir) const noexcept
+    {
+        auto const [dr, dc] = direction_to_vector(dir);
+        int k = 1;
+        while(in_bounds_(row + k * dr, col + k * dc) && mirror(row + k * dr, col + k * dc) == mirror_type::None)
+            ++k;
+        return k;
+    }
+
+private:
+    grid_array_t<int, N, N * N>          mirrors_;
+    [[no_unique_address]] grid_extent<N> length_;
+
+    INLINE constexpr int length_value_() const noexcept { return static_cast<int>(length_.value()); }
+
+    INLINE constexpr int to_idx_(int const row, int const col) const noexcept { return row * length_value_() + col; }
+
+    INLINE constexpr bool in_bounds_(int const row, int const col) const noexcept
+    {
+        return row >= 0 && row < length_value_() && col >= 0 && col < length_value_();
+    }
+};
+
+// Mirrors as bit planes: LR and RL words per row, and an occupied word per column. Neighbour and segment queries become
+// shifts and masks over a whole row or column instead of cell-by-cell scans. A per-cell reference count keeps the
+// semantics of `mirror_counter_storage`, and the planes follow the sign of the count. Grids are limited to 63 cells per
+// side so that every shift stays below the word width.
+template<size_t N = std::dynamic_extent>
+class mirror_bitboard_storage
+{
+public:
+    using word_type = uint64_t;
+
+    static constexpr size_t kMaxLength = std::numeric_limits<word_type>::digits - 1;
+
+    static_assert(N == std::dynamic_extent || N <= kMaxLength, "mirror_bitboard_storage: grid length exceeds 63");
+
+    constexpr explicit mirror_bitboard_storage(size_t const n)
+        : counts_(make_grid_array<decltype(counts_)>(n * n)),
+          rows_lr_(make_grid_array<decltype(rows_lr_)>(n)),
+          rows_rl_(make_grid_array<decltype(rows_rl_)>(n)),
+          cols_occupied_(make_grid_array<decltype(cols_occupied_)>(n)),
+          length_{n}
+    {
+        if(n > kMaxLength) [[unlikely]]
+            throw std::invalid_argument{"mirror_bitboard_storage: grid length exceeds 63"};
+    }
+
+    constexpr mirror_type mirror(int const row, int const col) const noexcept
+    {
+        auto const is_LR = (rows_lr_[row] >> col) & 1u;
+        auto const is_RL = (rows_rl_[row] >> col) & 1u;
+        return static_cast<mirror_type>(is_LR | (is_RL << 1));
+    }
+
+    constexpr int add(int const row, int const col, mirror_type const m) noexcept
+    {
+        auto const count = counts_[to_idx_(row, col)] += (m == mirror_type::LR) - (m == mirror_type::RL);
+        update_planes_(row, col, count);
+        return count;
+    }
+
+    constexpr int remove(int const row, int const col, mirror_type const m) noexcept
+    {
+        auto const count = counts_[to_idx_(row, col)] -= (m == mirror_type::LR) - (m == mirror_type::RL);
+        update_planes_(row, col, count);
+        return count;
+    }
+
+    constexpr bool has_adjacent_mirror(int const row, int const col) const noexcept
+    {
+        auto const row_bits = row_occupied_(row);
+        auto const col_bits = cols_occupied_[col];
+        return ((((row_bits << 1) | (row_bits >> 1)) >> col) | (((col_bits << 1) | (col_bits >> 1)) >> row)) & 1u;
+    }
+
+    constexpr bool is_path_clear(int const row, int const col, direction const dir, int const len) const noexcept
+    {
+        using enum direction;
+        switch(dir)
+        {
+        case Left:
+            return !in_line_(row) || (row_occupied_(row) & range_mask_(col - len, col - 1)) == 0;
+        case Right:
+            return !in_line_(row) || (row_occupied_(row) & range_mask_(col + 1, col + len)) == 0;
+        case Top:
+            return !in_line_(col) || (cols_occupied_[col] & range_mask_(row - len, row - 1)) == 0;
+        case Bottom:
+            return !in_line_(col) || (cols_occupied_[col] & range_mask_(row + 1, row + len)) == 0;
+        default:
+            return true;
+        }
+    }
+
+    // Precondition: the laser moves along a row or column inside the grid, i.e. from one of its cells or from a border
+    // entry position.
+    constexpr int distance_to_mirror(int const row, int const col, direction const dir) const noexcept
+    {
+        using enum direction;
+        switch(dir)
+        {
+        case Left:
+            return distance_backward_(row_occupied_(row), col);
+        case Right:
+            return distance_forward_(row_occupied_(row), col);
+        case Top:
+            return distance_backward_(cols_occupied_[col], row);
+        case Bottom:
+            return distance_forward_(cols_occupied_[col], row);
+        default:
+            return 0;
+        }
+    }
+
+private:
+    grid_array_t<int8_t, N, N * N>       counts_;
+    grid_array_t<word_type, N, N>        rows_lr_;
+    grid_array_t<word_type, N, N>        rows_rl_;
+    grid_array_t<word_type, N, N>        cols_occupied_;
+    [[no_unique_address]] grid_extent<N> length_;
+
+    INLINE constexpr int length_value_() const noexcept { return static_cast<int>(length_.value()); }
+
+    INLINE constexpr int to_idx_(int const row, int const col) const noexcept { return row * length_value_() + col; }
+
+    INLINE constexpr bool in_line_(int const i) const noexcept { return i >= 0 && i < length_value_(); }
+
+    INLINE constexpr word_type row_occupied_(int const row) const noexcept { return rows_lr_[row] | rows_rl_[row]; }
+
+    // Bits [lo, hi] clipped to the grid.
+    INLINE constexpr word_type range_mask_(int lo, int hi) const noexcept
+    {
+        lo = std::max(lo, 0);
+        hi = std::min(hi, length_value_() - 1);
+        return lo > hi ? 0 : (word_type{2} << hi) - (word_type{1} << lo);
+    }
+
+    INLINE constexpr int distance_forward_(word_type const line, int const from) const noexcept
+    {
+        auto const ahead = line >> (from + 1);
+        return ahead != 0 ? std::countr_zero(ahead) + 1 : length_value_() - from;
+    }
+
+    INLINE constexpr int distance_backward_(word_type const line, int const from) const noexcept
+    {
+        auto const behind = line & ((word_type{1} << from) - 1);
+        return behind != 0 ? from - std::bit_width(behind) + 1 : from + 1;
+    }
+
+    INLINE constexpr void update_planes_(int const row, int const col, int const count) noexcept
+    {
+        auto const col_bit = word_type{1} << col;
+        auto const row_bit = word_type{1} << row;
+        rows_lr_[row]       = (rows_lr_[row] & ~col_bit) | (word_type{count > 0} << col);
+        rows_rl_[row]       = (rows_rl_[row] & ~col_bit) | (word_type{count < 0} << col);
+        cols_occupied_[col] = (cols_occupied_[col] & ~row_bit) | (word_type{count != 0} << row);
+    }
+};
+
+// `N` fixes the grid length at compile time, so that index math and bounds checks fold into constants and all state
+// lives inline; the default keeps the length a runtime value.
+template<size_t N = std::dynamic_extent, template<size_t> class Storage = mirror_counter_storage>
 class mirror_grid
 {
 public:
-    using num_type = uint32_t;
+    using num_type     = uint32_t;
+    using result_type  = uint64_t;
+    using storage_type = Storage<N>;
+    using numbers_type = grid_array_t<num_type, N, 4 * N>;
+
+    static constexpr size_t extent = N;
 
     struct laser_position
     {
@@ -87,8 +351,8 @@ public:
         constexpr laser_position& advance(int const dist = 1) noexcept
         {
             auto const dir_vec = direction_to_vector(dir);
-            row += dir_vec[0];
-            col += dir_vec[1];
+            row += dir_vec[0] * dist;
+            col += dir_vec[1] * dist;
             return *this;
         }
 
@@ -144,21 +408,25 @@ public:
         }
     };
 
+    // Clue sums are wider than the clues, so their product fits for any realistic grid.
     struct result
     {
-        num_type left;
-        num_type top;
-        num_type right;
-        num_type bottom;
-        num_type product;
+        result_type left;
+        result_type top;
+        result_type right;
+        result_type bottom;
+        result_type product;
     };
 
     constexpr mirror_grid(size_t n)
-        : numbers_(4 * n, 0),
-          number_mask_(n * n, false),
-          mirrors_(n * n, 0),
+        : numbers_(make_grid_array<numbers_type>(4 * n)),
+          number_mask_(make_grid_array<decltype(number_mask_)>(4 * n)),
+          mirrors_(n),
           length_{n}
-    {}
+    {
+        if(N != std::dynamic_extent && n != N) [[unlikely]]
+            throw std::invalid_argument{"Grid length does not match the static grid extent"};
+    }
 
     constexpr mirror_grid(std::span<num_type const> left, std::span<num_type const> top,
                           std::span<num_type const> right, std::span<num_type const> bottom)
@@ -188,37 +456,24 @@ public:
         return numbers_[to_num_idx_(dir, i)];
     }
 
-    constexpr mirror_type mirror(int const row, int const col) const noexcept
-    {
-        bool const is_LR = mirrors_[to_idx_(row, col)] > 0;
-        bool const is_RL = mirrors_[to_idx_(row, col)] < 0;
-        return static_cast<mirror_type>(std::to_underlying(mirror_type::LR) * is_LR +
-                                        std::to_underlying(mirror_type::RL) * is_RL);
-    }
+    constexpr mirror_type mirror(int const row, int const col) const noexcept { return mirrors_.mirror(row, col); }
 
     constexpr bool in_bounds(int const row, int const col) const noexcept
     {
-        return row >= 0 && row < length_ && col >= 0 && col < length_;
+        int const n = length();
+        return row >= 0 && row < n && col >= 0 && col < n;
     }
 
     constexpr bool in_border(int const row, int const col, int const offset = 0) const noexcept
     {
-        return ((row == offset - 1 || row == length_ - offset) && (offset - 1 <= col) && (col <= length_ - offset)) ||
-               ((col == offset - 1 || col == length_ - offset) && (offset - 1 <= row) && (row <= length_ - offset));
+        int const n = length();
+        return ((row == offset - 1 || row == n - offset) && (offset - 1 <= col) && (col <= n - offset)) ||
+               ((col == offset - 1 || col == n - offset) && (offset - 1 <= row) && (row <= n - offset));
     }
 
     constexpr bool can_place_mirror(int const row, int const col) const noexcept
     {
-        static constexpr auto dirs = std::array<std::pair<int, int>, 4>{{{-1, 0}, {0, -1}, {1, 0}, {0, 1}}};
-
-        auto const check_adjacent_mirror = [&](std::pair<int, int> const& dir)
-        {
-            auto const nr = row + dir.first;
-            auto const nc = col + dir.second;
-            return this->in_bounds(nr, nc) && this->mirror(nr, nc) != mirror_type::None;
-        };
-
-        return std::ranges::none_of(dirs, check_adjacent_mirror);
+        return !mirrors_.has_adjacent_mirror(row, col);
     }
 
     constexpr bool can_place_mirror(int const row, int const col, mirror_type const m) const noexcept
@@ -233,42 +488,61 @@ public:
 
     constexpr auto add_mirror_counter(int const row, int const col, mirror_type const m) noexcept
     {
-        return mirrors_[to_idx_(row, col)] += (m == mirror_type::LR) - (m == mirror_type::RL);
+        return mirrors_.add(row, col, m);
     }
 
     constexpr auto remove_mirror_counter(int const row, int const col, mirror_type const m) noexcept
     {
-        return mirrors_[to_idx_(row, col)] -= (m == mirror_type::LR) - (m == mirror_type::RL);
+        return mirrors_.remove(row, col, m);
+    }
+
+    // True when none of the `len` cells after (row, col) in direction `dir` holds a mirror (cells outside are ignored).
+    constexpr bool is_path_clear(int const row, int const col, direction const dir, int const len) const noexcept
+    {
+        return mirrors_.is_path_clear(row, col, dir, len);
     }
 
-    constexpr result compute_result() const noexcept
+    // Steps from (row, col) in direction `dir` to the next mirror, or to the first position outside the grid.
+    constexpr int distance_to_mirror(int const row, int const col, direction const dir) const noexcept
     {
-        auto compute_clue_sum = [&](direction const dir) -> num_type
+        return mirrors_.distance_to_mirror(row, col, dir);
+    }
+
+    constexpr result compute_result() const
+    {
+        auto compute_clue_sum = [&](direction const dir) -> result_type
         {
             return std::ranges::fold_left(
-                std::views::iota(0u, length_), num_type{0}, [&](auto acc, auto i)
-                { return acc + this->boundary_number(dir, i) * number_mask_[to_num_idx_(dir, i)]; });
+                std::views::iota(size_t{0}, length()), result_type{0}, [&](auto acc, auto i)
+                { return acc + result_type{this->boundary_number(dir, i)} * number_mask_[to_num_idx_(dir, i)]; });
         };
 
         auto const left_sum   = compute_clue_sum(direction::Left);
         auto const top_sum    = compute_clue_sum(direction::Top);
         auto const right_sum  = compute_clue_sum(direction::Right);
         auto const bottom_sum = compute_clue_sum(direction::Bottom);
-        auto const product    = left_sum * top_sum * right_sum * bottom_sum;
+
+        auto product = result_type{1};
+        for(auto const sum: {left_sum, top_sum, right_sum, bottom_sum})
+        {
+            if(sum != 0 && product > std::numeric_limits<result_type>::max() / sum) [[unlikely]]
+                throw std::overflow_error{"Product of the clue sums does not fit in 64 bits"};
+            product *= sum;
+        }
 
         return {left_sum, top_sum, right_sum, bottom_sum, product};
     }
 
-    constexpr auto length() const noexcept { return length_; }
+    constexpr size_t length() const noexcept { return length_.value(); }
 
-    constexpr std::vector<num_type> const& numbers_array() const noexcept { return numbers_; }
-    constexpr std::vector<num_type>&       numbers_array() noexcept { return numbers_; }
+    constexpr numbers_type const& numbers_array() const noexcept { return numbers_; }
+    constexpr numbers_type&       numbers_array() noexcept { return numbers_; }
 
 private:
-    std::vector<num_type> numbers_;
-    std::vector<bool>     number_mask_;
-    std::vector<int>      mirrors_;
-    size_t                length_;
+    numbers_type                         numbers_;
+    grid_array_t<bool, N, 4 * N>         number_mask_;
+    storage_type                         mirrors_;
+    [[no_unique_address]] grid_extent<N> length_;
 
     INLINE static size_t validate_sizes_(size_t const l, size_t const t, size_t const r, size_t const b)
     {
@@ -277,22 +551,20 @@ private:
         return l;
     }
 
-    INLINE constexpr int to_idx_(int const row, int const col) const noexcept { return row * length_ + col; }
-
     INLINE constexpr int to_num_idx_(direction const dir, int const i) const noexcept
     {
-        return std::to_underlying(dir) * length_ + i;
+        return std::to_underlying(dir) * static_cast<int>(length()) + i;
     }
 };
 
 
-template<>
-struct fmt::formatter<mirror_grid>
+template<size_t N, template<size_t> class Storage>
+struct fmt::formatter<mirror_grid<N, Storage>>
 {
     constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
 
     template<class FormatContext>
-    auto format(mirror_grid const& grid, FormatContext& ctx) const
+    auto format(mirror_grid<N, Storage> const& grid, FormatContext& ctx) const
     {
         using namespace std::literals;
         using enum direction;
@@ -3,6 +3,10 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <numeric>
 #include <ranges>
 #include <span>
 #include <sys/syslimits.h>
@@ -15,18 +19,23 @@
 
 #include <spdlog/spdlog.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "2025/march/integer_factorizations.h"
 #include "2025/march/mirror_grid.h"
-#include "utils/restorer.h"
 
 
+template<class Grid = mirror_grid<>>
 class mirror_grid_solver
 {
 public:
-    using num_type       = mirror_grid::num_type;
-    using laser_position = mirror_grid::laser_position;
+    using grid_type      = Grid;
+    using num_type       = typename Grid::num_type;
+    using laser_position = typename Grid::laser_position;
 
-    mirror_grid_solver(mirror_grid& grid)
+    mirror_grid_solver(Grid& grid)
         : grid_{grid},
           factorizations_{}
     {}
@@ -34,7 +43,97 @@ public:
     bool solve()
     {
         init_factorizations_();
-        return try_next_number_();
+        init_propagation_();
+        init_path_cache_();
+        if(propagate_(0) && try_next_number_())
+            return true;
+
+        undo_to_(0);
+        return false;
+    }
+
+    // Solutions in the order the search reaches them, stopping once `limit` are found: the first one is the grid
+    // `solve()` returns, and `limit == 2` is enough to tell whether it is unique. The grid is left as the first
+    // solution, or unchanged when there is none.
+    std::vector<Grid> find_all(size_t const limit = std::numeric_limits<size_t>::max())
+    {
+        std::vector<Grid> solutions;
+        if(limit == 0)
+            return solutions;
+
+        init_factorizations_();
+        init_propagation_();
+        init_path_cache_();
+
+        solution_limit_ = limit;
+        solutions_      = &solutions;
+        if(!(propagate_(0) && try_next_number_()))
+            undo_to_(0);
+        solutions_ = nullptr;
+
+        if(!solutions.empty())
+            grid_ = solutions.front();
+        return solutions;
+    }
+
+    size_t count_solutions(size_t const limit = std::numeric_limits<size_t>::max()) { return find_all(limit).size(); }
+
+    // Splits the search into the subtrees left after the first few numbers are placed, taken in the order the serial
+    // search visits them, and searches them on the TBB work-stealing pool. Subtrees are handed out in batches of
+    // growing size, and subtrees after the earliest one holding a solution are cancelled, so the resulting grid is
+    // exactly the one found by `solve()`. A solution reached while collecting a batch, above the split depth, comes
+    // after every subtree collected so far and before the rest.
+    bool solve_parallel(int const max_concurrency = tbb::task_arena::automatic)
+    {
+        init_factorizations_();
+        init_propagation_();
+        init_path_cache_();
+        if(!propagate_(0))
+        {
+            undo_to_(0);
+            return false;
+        }
+
+        tbb::task_arena arena(max_concurrency);
+        auto            batch_size  = kTasksPerThread * static_cast<size_t>(arena.max_concurrency());
+        auto const      split_depth = estimate_split_depth_(batch_size);
+
+        spdlog::info("Splitting search at depth {} out of {} numbers", split_depth, factorizations_.size());
+
+        std::vector<search_node> nodes;
+        for(size_t skip = 0;; skip += nodes.size(), batch_size *= 2)
+        {
+            bool const is_collected_solved = collect_search_nodes_(split_depth, skip, batch_size, nodes);
+            if(nodes.empty() && !is_collected_solved)
+                break;
+
+            spdlog::debug("Searching subtrees [{}, {})", skip, skip + nodes.size());
+
+            std::atomic<size_t> best_task{nodes.size()};
+            arena.execute(
+                [&]
+                {
+                    tbb::parallel_for(tbb::blocked_range<size_t>(0, nodes.size(), 1),
+                                      [&](tbb::blocked_range<size_t> const& range)
+                                      {
+                                          for(auto task_idx = range.begin(); task_idx != range.end(); ++task_idx)
+                                              search_node_(nodes[task_idx], task_idx, best_task);
+                                      });
+                });
+
+            if(auto const solved_task = best_task.load(); solved_task < nodes.size())
+            {
+                grid_ = nodes[solved_task].grid;
+                return true;
+            }
+
+            // The grid still holds the solution the collection stopped at.
+            if(is_collected_solved)
+                return true;
+        }
+
+        undo_to_(0);
+        return false;
     }
 
     constexpr auto init() { init_factorizations_(); }
@@ -45,11 +144,166 @@ private:
     static constexpr auto kPlacements =
         std::array<direction, 4>{direction::Left, direction::Top, direction::Right, direction::Bottom};
 
-    mirror_grid& grid_;
+    static constexpr size_t kNoSplit        = std::numeric_limits<size_t>::max();
+    static constexpr size_t kTasksPerThread = 8;
+
+    // Probing a clue gives up after this many viable paths, and its cells are then left unconstrained.
+    static constexpr size_t kMaxProbePaths = 128;
+
+    static constexpr uint8_t kAllStates = 0b111;
+
+    static constexpr uint8_t state_bit_(mirror_type const m) noexcept { return 1u << std::to_underlying(m); }
+
+    // Grid state reached once the first `number_idx` numbers have a path, from which the search can be resumed.
+    struct search_node
+    {
+        Grid                 grid;
+        std::vector<uint8_t> domains;
+        std::vector<size_t>  order;
+        std::vector<size_t>  path_counts;
+        size_t               number_idx;
+    };
+
+    // One cell visited by the path being laid, with the state the path needs there.
+    struct path_cell
+    {
+        int         row;
+        int         col;
+        mirror_type state;
+    };
+
+    // Undo record for a narrowed cell domain, and for the mirror placed when it was narrowed to a single mirror.
+    struct domain_change
+    {
+        int         idx;
+        uint8_t     domain;
+        mirror_type forced;
+    };
+
+    // Cells covered by the viable paths of the clue being probed: on how many paths each cell lies and the union of
+    // the states those paths need there.
+    struct clue_probe
+    {
+        std::vector<uint32_t> hits;
+        std::vector<uint8_t>  states;
+        std::vector<uint32_t> last_path;
+        size_t                paths     = 0;
+        bool                  truncated = false;
+    };
+
+    Grid& grid_;
+
+    // Factorizations are owned by `factorization_cache` and never change, so workers share them.
+    std::vector<std::tuple<integer_factorizations const*, direction, int>> factorizations_{};
+
+    // Numbers are visited most constrained first: `order_` lists indices into `factorizations_`, the first `number_idx`
+    // of them with a path at depth `number_idx`, and `path_counts_` holds the paths each number had at the last
+    // propagation (`kMaxProbePaths + 1` when its probe gave up).
+    std::vector<size_t> order_;
+    std::vector<size_t> path_counts_;
+
+    // Laser path cache: the product of the path from every border entry, indexed like `numbers_array()`, and the cells
+    // it visits. `cell_entries_` holds, per cell, a bit set of the entries whose path visits it, and a mirror change on a
+    // cell marks those entries in `dirty_entries_`, so that only they are traced again.
+    std::vector<num_type>         path_products_;
+    std::vector<std::vector<int>> path_cells_;
+    std::vector<uint64_t>         cell_entries_;
+    std::vector<uint64_t>         dirty_entries_;
+    size_t                        entry_words_ = 0;
+
+    // Constraint propagation: per cell, the bit set of states {None, LR, RL} still possible. A domain without None
+    // always holds a single mirror, which is then also placed on the grid, so that path checks against the grid see it.
+    // `path_` holds the cells of the committed paths followed by the one being laid, which starts at `path_begin_`.
+    std::vector<uint8_t>       domains_;
+    std::vector<domain_change> trail_;
+    std::vector<path_cell>     path_;
+    size_t                     path_begin_ = 0;
+    clue_probe                 probe_;
+    bool                       is_probing_ = false;
+
+    // Frontier collection: `try_next_number_` records the state at `split_depth_` instead of descending further,
+    // skipping the first `frontier_skip_` states and stopping the search once `frontier_capacity_` are recorded.
+    size_t                    split_depth_       = kNoSplit;
+    size_t                    frontier_skip_     = 0;
+    size_t                    frontier_capacity_ = 0;
+    std::vector<search_node>* frontier_          = nullptr;
+
+    // Solution collection: completed grids go to `solutions_` and the search goes on until `solution_limit_` are found.
+    std::vector<Grid>* solutions_      = nullptr;
+    size_t             solution_limit_ = 0;
+
+    // Cancellation: a subtree search stops once a solution is known in an earlier subtree.
+    std::atomic<size_t> const* best_task_ = nullptr;
+    size_t                     task_idx_  = 0;
+
+    constexpr bool is_cancelled_() const noexcept
+    {
+        return (frontier_ != nullptr && frontier_->size() >= frontier_capacity_) ||
+               (best_task_ != nullptr && best_task_->load(std::memory_order_relaxed) < task_idx_) ||
+               (is_probing_ && probe_.truncated);
+    }
+
+    // Shallowest depth with enough subtrees to keep every worker busy, estimated from the path counts of the root
+    // propagation as if the least constrained numbers were placed last.
+    size_t estimate_split_depth_(size_t const batch_size) const
+    {
+        auto counts = path_counts_;
+        std::ranges::sort(counts);
+
+        size_t split_depth = 0;
+        for(size_t subtrees = 1; split_depth < counts.size() && subtrees < batch_size; ++split_depth)
+            subtrees *= std::max(counts[split_depth], size_t{1});
+        return std::max(split_depth, std::min(counts.size(), size_t{1}));
+    }
 
-    std::vector<std::tuple<integer_factorizations, direction, int>> factorizations_{};
+    // Collects into `nodes` up to `capacity` subtrees at `split_depth`, after skipping the first `skip` of them.
+    // Returns true when the search completes a grid above the split depth first, which is then left on the grid.
+    // Deeper propagations overwrite the order and path counts of the root, so they are put back for the next
+    // collection to visit the subtrees in the same order.
+    bool collect_search_nodes_(size_t const split_depth, size_t const skip, size_t const capacity,
+                               std::vector<search_node>& nodes)
+    {
+        nodes.clear();
+        nodes.reserve(capacity);
+
+        auto const root_order       = order_;
+        auto const root_path_counts = path_counts_;
+
+        split_depth_       = split_depth;
+        frontier_skip_     = skip;
+        frontier_capacity_ = capacity;
+        frontier_          = &nodes;
+        bool const is_solved = try_next_number_();
+        split_depth_ = kNoSplit;
+        frontier_    = nullptr;
+        order_       = root_order;
+        path_counts_ = root_path_counts;
+
+        return is_solved;
+    }
 
-    std::vector<uint32_t> numbers_storage_;
+    void search_node_(search_node& node, size_t const task_idx, std::atomic<size_t>& best_task) const
+    {
+        if(best_task.load(std::memory_order_relaxed) < task_idx)
+            return;
+
+        mirror_grid_solver worker(node.grid);
+        worker.factorizations_ = factorizations_;
+        worker.best_task_      = &best_task;
+        worker.task_idx_       = task_idx;
+        worker.init_propagation_();
+        worker.init_path_cache_();
+        worker.domains_     = node.domains;
+        worker.order_       = node.order;
+        worker.path_counts_ = node.path_counts;
+
+        if(!worker.try_next_number_(node.number_idx))
+            return;
+
+        auto current = best_task.load();
+        while(task_idx < current && !best_task.compare_exchange_weak(current, task_idx))
+        {}
+    }
 
     // Branchless way to determine which mirror should be placed to terminate the path when is at the border `loc`
     // approaching from the direaction `dir`
@@ -79,19 +333,31 @@ private:
                 if(x == 0)
                     continue;
 
-                factorizations_.emplace_back(integer_factorizations(x, grid_len), placement, loc);
+                factorizations_.emplace_back(&factorization_cache::get(x, grid_len), placement, loc);
             }
         }
 
         std::ranges::sort(factorizations_,
-                          [](auto const& a, auto const& b) { return std::get<0>(a).size() < std::get<0>(b).size(); });
+                          [](auto const& a, auto const& b) { return std::get<0>(a)->size() < std::get<0>(b)->size(); });
 
         spdlog::debug("Number order: {}",
-                      factorizations_ | std::views::transform([](auto& t) { return std::get<0>(t).number(); }));
+                      factorizations_ | std::views::transform([](auto& t) { return std::get<0>(t)->number(); }));
     }
 
     constexpr bool try_next_number_(size_t const number_idx = 0)
     {
+        if(number_idx == split_depth_) [[unlikely]]
+        {
+            if(frontier_skip_ > 0)
+                --frontier_skip_;
+            else
+                frontier_->push_back({grid_, domains_, order_, path_counts_, number_idx});
+            return false;
+        }
+
+        if(is_cancelled_())
+            return false;
+
         if(number_idx >= factorizations_.size())
         {
             spdlog::debug("Completed iterating input numbers. Trying to complete grid: \n{}", grid_);
@@ -99,23 +365,40 @@ private:
         }
 
         spdlog::debug("CURRENT STATE: \n{}", grid_);
-        spdlog::debug("Trying number_idx={} out of {} numbers", number_idx, factorizations_.size());
+        select_next_number_(number_idx);
+        spdlog::debug("Trying number_idx={} out of {} numbers ({} paths)", number_idx, factorizations_.size(),
+                      path_counts_[order_[number_idx]]);
 
-        auto& [factorizations, placement, loc] = factorizations_[number_idx];
-        spdlog::debug("Started with number {} on {}[{}]", factorizations.number(), placement, loc);
+        return try_number_paths_(number_idx);
+    }
+
+    // Moves the remaining number with the fewest paths to `number_idx`, ties going to the fewest factorizations. The
+    // choice only depends on the set of remaining numbers, so every search visits the same tree.
+    constexpr void select_next_number_(size_t const number_idx)
+    {
+        auto const remaining = std::span{order_}.subspan(number_idx);
+        auto const best =
+            std::ranges::min_element(remaining, {}, [&](size_t const i) { return std::pair{path_counts_[i], i}; });
+        std::iter_swap(remaining.begin(), best);
+    }
+
+    // Lays every path of the number at `number_idx` in turn, each one continuing into `on_path_complete_`.
+    constexpr bool try_number_paths_(size_t const number_idx)
+    {
+        auto const& [factorizations, placement, loc] = factorizations_[order_[number_idx]];
+        spdlog::debug("Started with number {} on {}[{}]", factorizations->number(), placement, loc);
 
         auto const start_pos = laser_position::start_position(placement, loc, grid_.length()).advance();
 
-        for(auto factors: factorizations | std::views::reverse)
+        for(auto const factors: *factorizations | std::views::reverse)
         {
-            auto const total_factors =
-                std::ranges::fold_left(factors, uint32_t{0}, [](uint32_t acc, auto const& f) { return acc + f.count; });
+            ordered_factors sequence(factors);
 
             spdlog::debug("Trying factorization {} of {}[{}]={} (total_factors={}). Starting at ({},{}), dir={}",
-                          factors, placement, loc, factorizations.number(), total_factors, start_pos.row, start_pos.col,
-                          start_pos.dir);
+                          factors, placement, loc, factorizations->number(), sequence.length(), start_pos.row,
+                          start_pos.col, start_pos.dir);
 
-            if(try_next_factor_(number_idx, factors, 0, total_factors, start_pos))
+            if(try_next_factor_(number_idx, sequence, start_pos))
                 return true;
         }
 
@@ -124,140 +407,248 @@ private:
 
     constexpr bool try_complete_grid_()
     {
-        // qs::restorer_bind(ref, external) avoids allocating a new vector to backup grid_.numbers_array() per call
-        // This only works because not more recursive calls are made for the function.
-        qs::restorer rx(qs::defer_restore, qs::restorer_bind(grid_.numbers_array(), numbers_storage_));
-
-        int const grid_len = grid_.length();
+        update_path_cache_();
 
-        for(auto const placement: kPlacements)
+        auto const& numbers = grid_.numbers_array();
+        for(size_t entry = 0; entry < path_products_.size(); ++entry)
         {
-            for(auto const loc: std::views::iota(0, grid_len))
+            if(numbers[entry] != 0 && numbers[entry] != path_products_[entry])
             {
-                auto       pos       = laser_position::start_position(placement, loc, grid_len);
-                auto const start_num = grid_.boundary_number(placement, loc);
+                spdlog::debug("Path from border entry {} resulted in number={}, but expected {}.", entry,
+                              path_products_[entry], numbers[entry]);
+                return false;
+            }
+        }
 
-                spdlog::trace("Starting path from {}[{}] = {}, at ({}, {}), dir={}", placement, loc, start_num, pos.row,
-                              pos.col, pos.dir);
+        if(solutions_ == nullptr)
+        {
+            std::ranges::copy(path_products_, grid_.numbers_array().begin());
+            spdlog::debug("COMPLETED GRID: \n{}", grid_);
+            return true;
+        }
 
-                int segment_len   = 0;
-                int num_from_path = 1;
+        if(std::ranges::none_of(*solutions_, [&](Grid const& g) { return has_same_mirrors_(g); }))
+        {
+            solutions_->push_back(grid_);
+            std::ranges::copy(path_products_, solutions_->back().numbers_array().begin());
+            spdlog::debug("COMPLETED GRID: \n{}", solutions_->back());
+        }
+        return solutions_->size() >= solution_limit_;
+    };
 
-                do
-                {
-                    pos.advance();
-                    ++segment_len;
+    void init_path_cache_()
+    {
+        auto const grid_len = grid_.length();
+        auto const entries  = 4 * grid_len;
+
+        entry_words_ = (entries + 63) / 64;
+        path_products_.assign(entries, 0);
+        path_cells_.resize(entries);
+        for(auto& cells: path_cells_)
+            cells.clear();
+        cell_entries_.assign(grid_len * grid_len * entry_words_, 0);
+
+        // Every path starts out dirty.
+        dirty_entries_.assign(entry_words_, ~uint64_t{0});
+        if(auto const tail = entries % 64; tail != 0)
+            dirty_entries_.back() = (uint64_t{1} << tail) - 1;
+    }
 
-                    auto const curr_mirror = grid_.mirror(pos.row, pos.col);
-                    auto const next_dir    = direction_after_mirror(curr_mirror, pos.dir);
-                    if(pos.dir != next_dir)
-                    {
-                        num_from_path *= segment_len;
-                        segment_len = 0;
-                        pos.dir     = next_dir;
-                    }
-                }
-                while(grid_.in_bounds(pos.row, pos.col));
+    // Mirror counts are positive for LR and negative for RL, so the mirror on a cell changes exactly when its count
+    // reaches or leaves zero.
+    constexpr void add_mirror_(int const row, int const col, mirror_type const m)
+    {
+        auto const step  = (m == mirror_type::LR) ? 1 : -1;
+        auto const count = grid_.add_mirror_counter(row, col, m);
+        if(count == step || count == 0)
+            invalidate_paths_(row, col);
+    }
 
-                if(segment_len > 0)
-                    num_from_path *= segment_len;
+    constexpr void remove_mirror_(int const row, int const col, mirror_type const m)
+    {
+        auto const step  = (m == mirror_type::LR) ? 1 : -1;
+        auto const count = grid_.remove_mirror_counter(row, col, m);
+        if(count == -step || count == 0)
+            invalidate_paths_(row, col);
+    }
 
-                bool const is_valid_endpoint = start_num == 0 || start_num == num_from_path;
-                if(!is_valid_endpoint)
-                {
-                    spdlog::debug(
-                        "Ending path from {}[{}], arriving at ({},{}), dir={}. Resulted in number={}, but expected {}.",
-                        placement, loc, pos.row, pos.col, pos.dir, num_from_path, start_num);
+    constexpr void invalidate_paths_(int const row, int const col)
+    {
+        auto const entries = cell_entries_.begin() + to_cell_idx_(row, col) * entry_words_;
+        for(size_t w = 0; w < entry_words_; ++w)
+            dirty_entries_[w] |= entries[w];
+    }
 
-                    rx.restore();
-                    return false;
-                }
+    constexpr void update_path_cache_()
+    {
+        for(size_t w = 0; w < entry_words_; ++w)
+        {
+            for(auto bits = std::exchange(dirty_entries_[w], 0); bits != 0; bits &= bits - 1)
+                trace_path_(w * 64 + std::countr_zero(bits));
+        }
+    }
 
-                spdlog::debug("Ending path from {}[{}] = {}, arriving at ({},{}), dir={}. Setting to value {}.",
-                              placement, loc, start_num, pos.row, pos.col, pos.dir, num_from_path);
-                grid_.boundary_number(placement, loc) = num_from_path;
+    // Traces the laser from border entry `entry` again, jumping from mirror to mirror: every jump is one segment of the
+    // path, the last one leaves the grid.
+    constexpr void trace_path_(size_t const entry)
+    {
+        int const  grid_len  = grid_.length();
+        auto const placement = kPlacements[entry / grid_len];
+        auto const loc       = static_cast<int>(entry % grid_len);
+        auto const word      = entry / 64;
+        auto const bit       = uint64_t{1} << (entry % 64);
+
+        auto& cells = path_cells_[entry];
+        for(auto const cell: cells)
+            cell_entries_[cell * entry_words_ + word] &= ~bit;
+        cells.clear();
+
+        auto     pos           = laser_position::start_position(placement, loc, grid_len);
+        num_type num_from_path = 1;
+        while(true)
+        {
+            auto const segment_len = grid_.distance_to_mirror(pos.row, pos.col, pos.dir);
+            auto const [dr, dc]    = direction_to_vector(pos.dir);
+            for(int k = 1; k <= segment_len; ++k)
+            {
+                if(grid_.in_bounds(pos.row + k * dr, pos.col + k * dc))
+                    cells.push_back(to_cell_idx_(pos.row + k * dr, pos.col + k * dc));
             }
+
+            pos.advance(segment_len);
+            num_from_path *= segment_len;
+
+            if(!grid_.in_bounds(pos.row, pos.col))
+                break;
+
+            pos.dir = direction_after_mirror(grid_.mirror(pos.row, pos.col), pos.dir);
         }
 
-        spdlog::debug("COMPLETED GRID: \n{}", grid_);
+        for(auto const cell: cells)
+            cell_entries_[cell * entry_words_ + word] |= bit;
+        path_products_[entry] = num_from_path;
+
+        spdlog::trace("Traced path from {}[{}], arriving at ({},{}), dir={}. Resulted in number={}.", placement, loc,
+                      pos.row, pos.col, pos.dir, num_from_path);
+    }
+
+    constexpr bool has_same_mirrors_(Grid const& other) const noexcept
+    {
+        int const grid_len = grid_.length();
+        for(int row = 0; row < grid_len; ++row)
+        {
+            for(int col = 0; col < grid_len; ++col)
+            {
+                if(grid_.mirror(row, col) != other.mirror(row, col))
+                    return false;
+            }
+        }
         return true;
-    };
+    }
 
-    constexpr bool is_laser_path_valid_(laser_position const& start_pos, laser_position const& end_pos) const noexcept
+    constexpr int to_cell_idx_(int const row, int const col) const noexcept { return row * grid_.length() + col; }
+
+    constexpr bool can_place_mirror_(int const row, int const col, mirror_type const m) const noexcept
     {
-        auto       pos  = laser_position{start_pos.row, start_pos.col, end_pos.dir};
-        auto const dist = std::abs(end_pos.row - start_pos.row) + std::abs(end_pos.col - start_pos.col);
+        return grid_.can_place_mirror(row, col, m) && (domains_[to_cell_idx_(row, col)] & state_bit_(m));
+    }
+
+    // Records the cell a segment leaves from with its state, and the in-grid cells crossed up to the next one.
+    constexpr void push_segment_(laser_position const& from, mirror_type const m, laser_position const& to)
+    {
+        auto const dist = std::abs(to.row - from.row) + std::abs(to.col - from.col);
+        if(dist == 0)
+            return;
 
-        for(auto const k: std::views::iota(0, dist - 1))
+        path_.push_back({from.row, from.col, m});
+        auto const [dr, dc] = direction_to_vector(to.dir);
+        for(int k = 1; k < dist; ++k)
         {
-            pos.advance();
-            if(grid_.mirror(pos.row, pos.col) != mirror_type::None && grid_.in_bounds(pos.row, pos.col))
-                return false;
+            if(grid_.in_bounds(from.row + k * dr, from.col + k * dc))
+                path_.push_back({from.row + k * dr, from.col + k * dc, mirror_type::None});
         }
-        pos.advance();
+    }
+
+    constexpr bool is_laser_path_valid_(laser_position const& start_pos, laser_position const& end_pos) const noexcept
+    {
+        auto const dist = std::abs(end_pos.row - start_pos.row) + std::abs(end_pos.col - start_pos.col);
 
-        return end_pos.col == pos.col && end_pos.row == pos.row;
+        // Cells strictly between both ends must be free of mirrors. A zero-length segment (factor 1 without a mirror)
+        // leaves the laser where it is.
+        return grid_.is_path_clear(start_pos.row, start_pos.col, end_pos.dir, dist - 1);
     };
 
-    constexpr bool try_next_factor_(size_t const number_idx, std::span<integer_factorizations::factor>& factors,
-                                    size_t const factor_idx, size_t const total_factors, laser_position const& pos)
+    constexpr bool try_next_factor_(size_t const number_idx, ordered_factors& sequence, laser_position const& pos)
     {
-        if(factor_idx >= total_factors)
+        if(sequence.is_complete())
             return try_complete_factors_(number_idx, pos);
 
+        if(is_cancelled_())
+            return false;
+
+        auto const factor_idx = sequence.depth();
+
         // checks end of path is valid, checking last number can be placed on border
         auto is_pos_valid_ = [&](laser_position const& pos)
         {
-            if(factor_idx + 1 < total_factors)
+            if(factor_idx + 1 < sequence.length())
                 return grid_.in_bounds(pos.row, pos.col);
             else
                 return grid_.in_border(pos.row, pos.col, 0) || grid_.in_border(pos.row, pos.col, 1);
         };
 
-        // try to place mirror and continue pat
-        for(auto&& f: factors)
+        // try to place mirror and continue path with each distinct factor left, so that every ordering of the
+        // factorization is tried once
+        for(auto slot = sequence.first_slot(); slot < sequence.slot_count(); slot = sequence.next_slot(slot))
         {
-            if(f.count == 0)
-                continue;
-
-            qs::restorer rx(qs::defer_restore, f.count);
+            auto const base = sequence.base(slot);
 
             // We start the laser inside the grid (in_bounds == true), so that we can immediately place a mirror, which
             // has not cost to the product.
             for(auto const m: {mirror_type::LR, mirror_type::RL})
             {
-                auto const pos_after_mirror = laser_position::next_after_mirror(pos, m, f.base);
+                auto const pos_after_mirror = laser_position::next_after_mirror(pos, m, base);
 
-                if(is_pos_valid_(pos_after_mirror) && grid_.can_place_mirror(pos.row, pos.col, m) &&
+                if(is_pos_valid_(pos_after_mirror) && can_place_mirror_(pos.row, pos.col, m) &&
                    is_laser_path_valid_(pos, pos_after_mirror))
                 {
-                    spdlog::debug("Trying factor {} of {} and mirror={}, from ({},{}) to ({},{}), with dir={}.", f.base,
-                                  factors, m, pos.row, pos.col, pos_after_mirror.row, pos_after_mirror.col,
-                                  pos_after_mirror.dir);
+                    spdlog::debug("Trying factor {} after {} and mirror={}, from ({},{}) to ({},{}), with dir={}.",
+                                  base, sequence.prefix(), m, pos.row, pos.col, pos_after_mirror.row,
+                                  pos_after_mirror.col, pos_after_mirror.dir);
 
-                    grid_.add_mirror_counter(pos.row, pos.col, m);
+                    auto const path_size = path_.size();
+                    add_mirror_(pos.row, pos.col, m);
+                    sequence.push(slot);
+                    push_segment_(pos, m, pos_after_mirror);
 
-                    if(try_next_factor_(number_idx, factors, factor_idx + 1, total_factors, pos_after_mirror))
+                    if(try_next_factor_(number_idx, sequence, pos_after_mirror))
                         return true;
 
-                    grid_.remove_mirror_counter(pos.row, pos.col, m);
+                    path_.resize(path_size);
+                    sequence.pop();
+                    remove_mirror_(pos.row, pos.col, m);
                 }
             }
 
             // We can allow laser going perpendiculat ot the number placement. Since the laser starts on the inside
             // of the grid we reduce the number of square to move by 1.
-            auto const pos_after_none = laser_position::next_after_mirror(pos, mirror_type::None, f.base - 1);
-            if(factor_idx == 0 && is_pos_valid_(pos_after_none) && is_laser_path_valid_(pos, pos_after_none))
+            auto const pos_after_none = laser_position::next_after_mirror(pos, mirror_type::None, base - 1);
+            if(factor_idx == 0 && is_pos_valid_(pos_after_none) && is_laser_path_valid_(pos, pos_after_none) &&
+               (domains_[to_cell_idx_(pos.row, pos.col)] & state_bit_(mirror_type::None)))
             {
-                spdlog::debug(
-                    "Trying factor {} of {} and no mirror (factor_idx==0), from ({},{}) to ({},{}) with dir={}.",
-                    f.base, factors, pos.row, pos.col, pos_after_none.row, pos_after_none.col, pos_after_none.dir);
+                spdlog::debug("Trying factor {} and no mirror (factor_idx==0), from ({},{}) to ({},{}) with dir={}.",
+                              base, pos.row, pos.col, pos_after_none.row, pos_after_none.col, pos_after_none.dir);
+
+                auto const path_size = path_.size();
+                sequence.push(slot);
+                push_segment_(pos, mirror_type::None, pos_after_none);
 
-                if(try_next_factor_(number_idx, factors, factor_idx + 1, total_factors, pos_after_none))
+                if(try_next_factor_(number_idx, sequence, pos_after_none))
                     return true;
-            }
 
-            rx.restore();
+                path_.resize(path_size);
+                sequence.pop();
+            }
         };
 
         return false;
@@ -265,7 +656,7 @@ private:
 
     constexpr bool try_complete_factors_(size_t const number_idx, laser_position const& end_pos)
     {
-        auto const& factorization = std::get<0>(factorizations_[number_idx]);
+        auto const& factorization = *std::get<0>(factorizations_[order_[number_idx]]);
         auto const  start_num     = factorization.number();
 
         auto const conditions = std::array<std::tuple<direction, bool, bool>, 4>{
@@ -297,7 +688,7 @@ private:
 
             grid_.boundary_number(end_placement, end_loc) = start_num;
 
-            if(try_next_number_(number_idx + 1))
+            if(on_path_complete_(number_idx))
                 return true;
 
             grid_.boundary_number(end_placement, end_loc) = end_num;
@@ -323,7 +714,7 @@ private:
 
             bool const is_valid_endpoint = (end_num == 0) | (end_num == start_num);
             bool const can_place_mirror  = (required_mirror != mirror_type::None) &&
-                                          grid_.can_place_mirror(end_pos.row, end_pos.col, required_mirror);
+                                          can_place_mirror_(end_pos.row, end_pos.col, required_mirror);
             if(!(is_valid_endpoint & can_place_mirror))
             {
                 spdlog::debug("Invalid path reached adjacent to {}[{}]={} from dir={} "
@@ -334,17 +725,192 @@ private:
             }
 
             grid_.boundary_number(end_placement, end_loc) = start_num;
-            grid_.add_mirror_counter(end_pos.row, end_pos.col, required_mirror);
+            add_mirror_(end_pos.row, end_pos.col, required_mirror);
+            path_.push_back({end_pos.row, end_pos.col, required_mirror});
 
-            if(try_next_number_(number_idx + 1))
+            if(on_path_complete_(number_idx))
                 return true;
 
-            grid_.remove_mirror_counter(end_pos.row, end_pos.col, required_mirror);
+            path_.pop_back();
+            remove_mirror_(end_pos.row, end_pos.col, required_mirror);
             grid_.boundary_number(end_placement, end_loc) = end_num;
         }
 
         return false;
     }
+
+    void init_propagation_()
+    {
+        auto const cells = grid_.length() * grid_.length();
+        domains_.assign(cells, kAllStates);
+        order_.resize(factorizations_.size());
+        std::iota(order_.begin(), order_.end(), size_t{0});
+        path_counts_.assign(factorizations_.size(), kMaxProbePaths + 1);
+        trail_.clear();
+        trail_.reserve(cells);
+        path_.clear();
+        path_.reserve(4 * cells);
+        path_begin_ = 0;
+        probe_.hits.assign(cells, 0);
+        probe_.states.assign(cells, 0);
+        probe_.last_path.assign(cells, 0);
+    }
+
+    // The path of the number at `number_idx` is laid out in `path_`. While probing it is only recorded; otherwise the
+    // cells it crosses are fixed, the remaining numbers are propagated, and the search moves on to the next number.
+    constexpr bool on_path_complete_(size_t const number_idx)
+    {
+        if(is_probing_)
+        {
+            record_probe_path_();
+            return false;
+        }
+
+        auto const trail_size = trail_.size();
+        auto const path_begin = std::exchange(path_begin_, path_.size());
+
+        bool const is_solved =
+            commit_path_(path_begin) && propagate_(number_idx + 1) && try_next_number_(number_idx + 1);
+
+        path_begin_ = path_begin;
+        if(!is_solved)
+            undo_to_(trail_size);
+        return is_solved;
+    }
+
+    // Fixes every cell of the laid path to the state it needs: mirrors stay, crossed cells can no longer get one.
+    constexpr bool commit_path_(size_t const path_begin)
+    {
+        return std::ranges::all_of(path_ | std::views::drop(path_begin), [&](path_cell const& c)
+                                   { return restrict_domain_(c.row, c.col, state_bit_(c.state)); });
+    }
+
+    // Narrows the domain of a cell to `allowed`, placing the mirror when a single one is left. Intersections with two
+    // mirrors and no None are skipped, to keep every mirror-only domain placed on the grid.
+    constexpr bool restrict_domain_(int const row, int const col, uint8_t const allowed)
+    {
+        auto const idx    = to_cell_idx_(row, col);
+        auto const domain = domains_[idx];
+        auto const narrow = static_cast<uint8_t>(domain & allowed);
+
+        if(narrow == domain)
+            return true;
+        if(narrow == 0)
+            return false;
+
+        if(narrow & state_bit_(mirror_type::None))
+        {
+            trail_.push_back({idx, domain, mirror_type::None});
+            domains_[idx] = narrow;
+            return true;
+        }
+
+        if(!std::has_single_bit(narrow))
+            return true;
+
+        auto const m = static_cast<mirror_type>(std::countr_zero(narrow));
+        if(!grid_.can_place_mirror(row, col, m))
+            return false;
+
+        // A mirror laid by a committed path is already on the grid.
+        auto const forced = grid_.mirror(row, col) == m ? mirror_type::None : m;
+        if(forced != mirror_type::None)
+            add_mirror_(row, col, forced);
+
+        trail_.push_back({idx, domain, forced});
+        domains_[idx] = narrow;
+        return true;
+    }
+
+    constexpr void undo_to_(size_t const trail_size)
+    {
+        int const grid_len = grid_.length();
+        while(trail_.size() > trail_size)
+        {
+            auto const& change = trail_.back();
+            if(change.forced != mirror_type::None)
+                remove_mirror_(change.idx / grid_len, change.idx % grid_len, change.forced);
+            domains_[change.idx] = change.domain;
+            trail_.pop_back();
+        }
+    }
+
+    // Probes every number from `number_idx` on until no domain changes: a number left without a path fails the node,
+    // and a cell every path of a number crosses is narrowed to the states those paths need there.
+    constexpr bool propagate_(size_t const number_idx)
+    {
+        int const grid_len = grid_.length();
+
+        for(bool changed = true; changed;)
+        {
+            changed = false;
+            for(auto idx = number_idx; idx < factorizations_.size(); ++idx)
+            {
+                bool const has_path = probe_number_(idx);
+                if(is_cancelled_())
+                    return false;
+                if(!has_path)
+                {
+                    spdlog::debug("Propagation: no path left for number_idx={}", idx);
+                    return false;
+                }
+                path_counts_[order_[idx]] = probe_.truncated ? kMaxProbePaths + 1 : probe_.paths;
+                if(probe_.truncated)
+                    continue;
+
+                auto const trail_size = trail_.size();
+                for(int cell = 0; cell < grid_len * grid_len; ++cell)
+                {
+                    if(probe_.hits[cell] != probe_.paths)
+                        continue;
+                    if(!restrict_domain_(cell / grid_len, cell % grid_len, probe_.states[cell]))
+                    {
+                        spdlog::debug("Propagation: conflicting cell ({},{}) for number_idx={}", cell / grid_len,
+                                      cell % grid_len, idx);
+                        return false;
+                    }
+                }
+                changed |= trail_.size() != trail_size;
+            }
+        }
+
+        return true;
+    }
+
+    // Enumerates the paths of the number at `number_idx` on the current grid into `probe_`. Returns false when there is
+    // none.
+    constexpr bool probe_number_(size_t const number_idx)
+    {
+        std::ranges::fill(probe_.hits, 0);
+        std::ranges::fill(probe_.states, 0);
+        std::ranges::fill(probe_.last_path, 0);
+        probe_.paths     = 0;
+        probe_.truncated = false;
+
+        is_probing_ = true;
+        try_number_paths_(number_idx);
+        is_probing_ = false;
+
+        return probe_.paths > 0 || probe_.truncated;
+    }
+
+    constexpr void record_probe_path_()
+    {
+        if(probe_.paths == kMaxProbePaths)
+        {
+            probe_.truncated = true;
+            return;
+        }
+
+        auto const path_id = static_cast<uint32_t>(++probe_.paths);
+        for(auto const& c: path_ | std::views::drop(path_begin_))
+        {
+            auto const idx = to_cell_idx_(c.row, c.col);
+            probe_.hits[idx] += probe_.last_path[idx] != path_id;
+            probe_.last_path[idx] = path_id;
+            probe_.states[idx] |= state_bit_(c.state);
+        }
+    }
 };
 
 
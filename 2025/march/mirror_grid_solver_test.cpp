@@ -0,0 +1,126 @@
+#include "2025/march/mirror_grid_solver.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <gtest/gtest.h>
+
+#include "2025/march/mirror_grid.h"
+
+
+namespace
+{
+
+// The left, top, right and bottom numbers of a grid.
+using puzzle = std::array<std::vector<uint32_t>, 4>;
+
+// The puzzles solved by mirrors_3, grids where a solution is reached above the split depth, and random small grids
+// with and without a solution.
+std::vector<puzzle> const kPuzzles = {
+    {{{0, 0, 0, 16, 0}, {0, 0, 9, 0, 0}, {0, 75, 0, 0, 0}, {0, 0, 36, 0, 0}}},
+    {{{0, 0, 0, 27, 0, 0, 0, 12, 225, 0},
+      {0, 0, 112, 0, 48, 3087, 9, 0, 0, 1},
+      {0, 4, 27, 0, 0, 0, 16, 0, 0, 0},
+      {2025, 0, 0, 12, 64, 5, 0, 405, 0, 0}}},
+    {{{16, 0, 6, 0}, {0, 6, 0, 1}, {1, 0, 0, 0}, {0, 0, 0, 0}}},
+    {{{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 4}, {4, 0, 0, 0}}},
+    {{{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}}},
+    {{{2, 0, 16, 0, 3, 0, 0}, {0, 0, 0, 0, 0, 0, 0}, {0, 6, 30, 0, 9, 0, 0}, {0, 0, 0, 8, 0, 0, 0}}},
+    {{{0, 0, 3, 8, 0, 12, 0}, {3, 0, 25, 0, 0, 8, 0}, {0, 0, 0, 0, 25, 0, 0}, {0, 0, 0, 0, 3, 0, 0}}},
+    {{{6, 14, 0, 0, 0, 0, 28}, {0, 36, 0, 0, 15, 6, 0}, {0, 14, 0, 0, 0, 36, 0}, {0, 0, 0, 0, 0, 0, 0}}},
+    {{{0, 0, 0, 0, 0, 6, 0}, {0, 0, 3, 0, 0, 0, 3}, {0, 8, 0, 0, 0, 0, 3}, {0, 0, 6, 16, 0, 32, 0}}},
+    {{{0, 6, 0, 0, 0, 60, 0}, {8, 0, 6, 4, 0, 8, 0}, {0, 0, 0, 0, 30, 0, 0}, {0, 0, 0, 0, 0, 0, 0}}},
+    {{{0, 0, 8, 0, 0, 0, 0}, {0, 42, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 8, 0, 42}, {4, 0, 8, 0, 28, 0, 0}}},
+    {{{0, 16, 0, 0, 0, 12, 0, 0}, {0, 21, 0, 0, 0, 0, 0, 16}, {0, 0, 0, 0, 0, 0, 4, 7}, {0, 7, 9, 0, 0, 0, 0, 0}}},
+};
+
+template<class Grid>
+Grid make_grid(puzzle const& p)
+{
+    auto const& [left, top, right, bottom] = p;
+    return Grid(std::span<uint32_t const>(left), std::span<uint32_t const>(top), std::span<uint32_t const>(right),
+                std::span<uint32_t const>(bottom));
+}
+
+template<class Grid>
+void expect_same_mirrors(Grid const& a, Grid const& b)
+{
+    int const n = a.length();
+    for(int r = 0; r < n; ++r)
+    {
+        for(int c = 0; c < n; ++c)
+            EXPECT_EQ(a.mirror(r, c), b.mirror(r, c)) << "at row " << r << ", col " << c;
+    }
+}
+
+template<class Grid>
+void expect_parallel_matches_serial(int const jobs)
+{
+    for(auto const& p: kPuzzles)
+    {
+        SCOPED_TRACE(fmt::format("jobs={} puzzle={}", jobs, p));
+
+        auto serial_grid = make_grid<Grid>(p);
+        auto grid        = make_grid<Grid>(p);
+
+        bool const is_serial_solved = mirror_grid_solver(serial_grid).solve();
+        bool const is_solved        = mirror_grid_solver(grid).solve_parallel(jobs);
+
+        ASSERT_EQ(is_solved, is_serial_solved);
+        if(is_solved)
+            expect_same_mirrors(grid, serial_grid);
+    }
+}
+
+} // namespace
+
+
+TEST(MirrorGridSolverTest, ParallelMatchesSerialWithCounters)
+{
+    for(int const jobs: {1, 2, 4})
+        expect_parallel_matches_serial<mirror_grid<>>(jobs);
+}
+
+TEST(MirrorGridSolverTest, ParallelMatchesSerialWithBitboards)
+{
+    for(int const jobs: {1, 2, 4})
+        expect_parallel_matches_serial<mirror_grid<std::dynamic_extent, mirror_bitboard_storage>>(jobs);
+}
+
+TEST(MirrorGridSolverTest, SolvesPuzzle)
+{
+    auto grid = make_grid<mirror_grid<>>(kPuzzles[1]);
+    ASSERT_TRUE(mirror_grid_solver(grid).solve_parallel(2));
+
+    auto const res = grid.compute_result();
+    EXPECT_EQ(res.left, 2251);
+    EXPECT_EQ(res.top, 480);
+    EXPECT_EQ(res.right, 166);
+    EXPECT_EQ(res.bottom, 3356);
+    EXPECT_EQ(res.product, 601'931'086'080);
+}
+
+TEST(MirrorGridSolverTest, ProductOfClueSumsIsWide)
+{
+    // Without mirrors every laser crosses the grid in one segment of length `n + 1`, so each side sums to
+    // `n * (n + 1)`.
+    auto const empty_puzzle = [](size_t const n)
+    {
+        auto const side = std::vector<uint32_t>(n, 0);
+        return puzzle{side, side, side, side};
+    };
+
+    auto grid = make_grid<mirror_grid<>>(empty_puzzle(20));
+    ASSERT_TRUE(mirror_grid_solver(grid).solve());
+    EXPECT_EQ(grid.compute_result().product, 31'116'960'000);
+
+    auto huge_grid = make_grid<mirror_grid<>>(empty_puzzle(300));
+    ASSERT_TRUE(mirror_grid_solver(huge_grid).solve());
+    EXPECT_THROW(huge_grid.compute_result(), std::overflow_error);
+}
@@ -1,6 +1,20 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fstream>
 #include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <print>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 #include <fmt/core.h>
@@ -12,6 +26,9 @@
 
 #include <CLI/CLI.hpp>
 
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
+
 #include "2025/march/mirror_grid.h"
 #include "2025/march/mirror_grid_solver.h"
 #include "spdlog/common.h"
@@ -21,7 +38,7 @@ static void init_logging(char const* log_file)
 {
     // auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_st>();
     // console_sink->set_level(spdlog::level::info);
-    auto basic_sink = std::make_shared<spdlog::sinks::basic_file_sink_st>(log_file, true);
+    auto basic_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file, true);
     basic_sink->set_level(spdlog::level::debug);
     auto logger = std::make_shared<spdlog::logger>("", spdlog::sinks_init_list{basic_sink});
     spdlog::set_default_logger(logger);
@@ -29,6 +46,270 @@ static void init_logging(char const* log_file)
 }
 
 
+enum class run_mode
+{
+    Solve,
+    Count,
+    Unique
+};
+
+// Grid lengths with a prebuilt fixed-size instantiation.
+static constexpr size_t kMinStaticLength = 5;
+static constexpr size_t kMaxStaticLength = 16;
+
+// Puzzles in flight per worker thread in batch mode, which bounds its memory.
+static constexpr size_t kBatchTokensPerThread = 4;
+
+
+// Builds the grid from its four sides and hands it to `f`. Common sizes use a prebuilt fixed-size grid; other grids
+// pick a dynamic one. Bit planes need the whole row or column in one word, so longer grids fall back to per-cell
+// counters.
+template<class F, class... Lists>
+static void with_grid(F&& f, Lists const&... ls)
+{
+    auto const n = std::max({ls.size()...});
+
+    auto const with_static = [&]<size_t... Is>(std::index_sequence<Is...>)
+    {
+        return ((n == kMinStaticLength + Is &&
+                 (f(mirror_grid<kMinStaticLength + Is, mirror_bitboard_storage>(ls...)), true)) ||
+                ...);
+    };
+
+    if(with_static(std::make_index_sequence<kMaxStaticLength - kMinStaticLength + 1>{}))
+        return;
+    if(n <= mirror_bitboard_storage<>::kMaxLength)
+        f(mirror_grid<std::dynamic_extent, mirror_bitboard_storage>(ls...));
+    else
+        f(mirror_grid<std::dynamic_extent, mirror_counter_storage>(ls...));
+}
+
+
+template<class Grid>
+static void count_and_print_grid(Grid grid, run_mode const mode)
+{
+    auto const n = grid.length();
+    fmt::println("Grid ({}*{}): {}", n, n, grid);
+    spdlog::info("Starting counting solutions of grid ({}*{})", n, n);
+
+    // Two solutions are enough to tell a unique grid apart.
+    auto const limit = (mode == run_mode::Unique) ? size_t{2} : std::numeric_limits<size_t>::max();
+
+    mirror_grid_solver solver(grid);
+    auto const         count = solver.count_solutions(limit);
+    spdlog::info("Finished grid ({}*{}). Solutions={}", n, n, count);
+
+    if(mode == run_mode::Unique)
+    {
+        auto const verdict = (count == 0) ? "no solution" : (count == 1 ? "a unique solution" : "multiple solutions");
+        fmt::println("Grid ({}*{}) has {}", n, n, verdict);
+    }
+    else
+        fmt::println("Grid ({}*{}) has {} solution(s)", n, n, count);
+}
+
+
+template<class Grid>
+static void solve_and_print_grid(Grid grid, run_mode const mode, int const jobs)
+{
+    if(mode != run_mode::Solve)
+    {
+        count_and_print_grid(std::move(grid), mode);
+        return;
+    }
+
+    auto const n = grid.length();
+    fmt::println("Grid ({}*{}): {}", n, n, grid);
+    spdlog::info("Starting solving grid ({}*{})", n, n);
+
+    mirror_grid_solver solver(grid);
+    bool const         is_solved =
+        (jobs == 1) ? solver.solve() : solver.solve_parallel(jobs == 0 ? tbb::task_arena::automatic : jobs);
+    spdlog::info("Finished grid ({}*{}). Solved={}", n, n, is_solved);
+
+    if(is_solved)
+    {
+        auto const res = grid.compute_result();
+        fmt::println("Left: {}, Top: {}, Right: {}, Bottom: {}, Product: {}", res.left, res.top, res.right, res.bottom,
+                     res.product);
+        fmt::println("Solved grid ({}*{}): {}", n, n, grid);
+    }
+    else
+        fmt::println("No solution found for grid ({}*{}): {}", n, n, grid);
+}
+
+
+// One puzzle per line: the left, top, right and bottom numbers as comma lists, separated by spaces or semicolons.
+static std::array<std::vector<uint32_t>, 4> parse_puzzle_line(std::string line)
+{
+    std::ranges::replace(line, ';', ' ');
+    std::istringstream stream(line);
+
+    std::array<std::vector<uint32_t>, 4> sides;
+    for(auto& side: sides)
+    {
+        std::string list;
+        if(!(stream >> list))
+            throw std::invalid_argument{"expected four comma separated lists"};
+
+        std::istringstream list_stream(list);
+        for(std::string number; std::getline(list_stream, number, ',');)
+        {
+            auto const* const last = number.data() + number.size();
+            uint32_t          value{};
+            auto const [ptr, ec] = std::from_chars(number.data(), last, value);
+            if(ec != std::errc{} || ptr != last)
+                throw std::invalid_argument{fmt::format("invalid number '{}'", number)};
+            side.push_back(value);
+        }
+    }
+
+    if(std::string extra; stream >> extra)
+        throw std::invalid_argument{"expected four comma separated lists"};
+    return sides;
+}
+
+
+// Escapes `text` for use inside a JSON string.
+static std::string json_escape(std::string_view const text)
+{
+    std::string out;
+    out.reserve(text.size());
+    for(char const ch: text)
+    {
+        switch(ch)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if(static_cast<unsigned char>(ch) < 0x20)
+                fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(ch));
+            else
+                out += ch;
+        }
+    }
+    return out;
+}
+
+
+// One JSON result line, and whether it holds a solved grid.
+struct json_result
+{
+    std::string text;
+    bool        is_solved = false;
+};
+
+
+template<class Grid>
+static json_result solve_to_json(size_t const line_no, Grid grid)
+{
+    static constexpr std::array mirror_chars{".", "\\\\", "/"};
+
+    mirror_grid_solver solver(grid);
+    if(!solver.solve())
+        return {fmt::format(R"({{"line":{},"solved":false}})", line_no)};
+
+    std::string out;
+    auto        it  = std::back_inserter(out);
+    auto const  res = grid.compute_result();
+    fmt::format_to(it, R"({{"line":{},"solved":true,"left":{},"top":{},"right":{},"bottom":{},"product":{},"grid":[)",
+                   line_no, res.left, res.top, res.right, res.bottom, res.product);
+
+    int const n = grid.length();
+    for(int r = 0; r < n; ++r)
+    {
+        fmt::format_to(it, "{}\"", r == 0 ? "" : ",");
+        for(int c = 0; c < n; ++c)
+            fmt::format_to(it, "{}", mirror_chars[std::to_underlying(grid.mirror(r, c))]);
+        fmt::format_to(it, "\"");
+    }
+    fmt::format_to(it, "]}}");
+    return {std::move(out), true};
+}
+
+
+static json_result solve_line_to_json(size_t const line_no, std::string const& line)
+{
+    try
+    {
+        auto const [left, top, right, bottom] = parse_puzzle_line(line);
+
+        json_result json;
+        with_grid([&](auto grid) { json = solve_to_json(line_no, std::move(grid)); }, left, top, right, bottom);
+        return json;
+    }
+    catch(std::exception const& e)
+    {
+        spdlog::warn("Skipping line {}: {}", line_no, e.what());
+        return {fmt::format(R"({{"line":{},"error":"{}"}})", line_no, json_escape(e.what()))};
+    }
+}
+
+
+// Streams puzzles from `in` through a TBB pipeline: lines are read and results written in order, while the puzzles in
+// between are solved in parallel. The number of puzzles in flight is bounded, so memory stays flat on long inputs.
+static void solve_batch(std::istream& in, int const jobs)
+{
+    struct batch_item
+    {
+        size_t      line_no;
+        std::string text;
+        bool        is_solved = false;
+    };
+
+    tbb::task_arena arena(jobs == 0 ? tbb::task_arena::automatic : jobs);
+    auto const      max_tokens = kBatchTokensPerThread * static_cast<size_t>(arena.max_concurrency());
+
+    size_t line_no = 0;
+    size_t solved  = 0;
+
+    auto const read_line = [&](tbb::flow_control& fc) -> batch_item
+    {
+        for(std::string line; std::getline(in, line);)
+        {
+            ++line_no;
+            if(auto const first = line.find_first_not_of(" \t\r"); first != std::string::npos && line[first] != '#')
+                return {line_no, std::move(line)};
+        }
+        fc.stop();
+        return {};
+    };
+
+    auto const solve_item = [](batch_item item) -> batch_item
+    {
+        auto [text, is_solved] = solve_line_to_json(item.line_no, item.text);
+        return {item.line_no, std::move(text), is_solved};
+    };
+
+    auto const write_item = [&](batch_item const& item)
+    {
+        solved += item.is_solved;
+        fmt::println("{}", item.text);
+    };
+
+    auto const filters = tbb::make_filter<void, batch_item>(tbb::filter_mode::serial_in_order, read_line) &
+                         tbb::make_filter<batch_item, batch_item>(tbb::filter_mode::parallel, solve_item) &
+                         tbb::make_filter<batch_item, void>(tbb::filter_mode::serial_in_order, write_item);
+
+    arena.execute([&] { tbb::parallel_pipeline(max_tokens, filters); });
+
+    spdlog::info("Finished batch: {} lines read, {} puzzles solved", line_no, solved);
+}
+
+
 int main(int argc, char** argv)
 {
     init_logging("mirrors_3.log");
@@ -38,6 +319,10 @@ int main(int argc, char** argv)
     std::vector<uint32_t> top;
     std::vector<uint32_t> right;
     std::vector<uint32_t> bottom;
+    int                   jobs   = 0;
+    bool                  count  = false;
+    bool                  unique = false;
+    std::string           batch_file;
 
     CLI::App app{"Hall of mirrors 3 solver"};
     argv            = app.ensure_utf8(argv);
@@ -45,6 +330,13 @@ int main(int argc, char** argv)
     auto opt_top    = app.add_option("-t,--top", top, "Top numbers of the grid")->delimiter(',');
     auto opt_right  = app.add_option("-r,--right", right, "Right numbers of the grid")->delimiter(',');
     auto opt_bottom = app.add_option("-b,--bottom", bottom, "Bottom numbers of the grid")->delimiter(',');
+    app.add_option("-j,--jobs", jobs, "Worker threads for the search (0: all cores, 1: serial)")
+        ->check(CLI::NonNegativeNumber);
+    auto opt_count  = app.add_flag("--count", count, "Count all solutions instead of solving");
+    auto opt_unique = app.add_flag("--unique", unique, "Check whether the grid has exactly one solution");
+    opt_unique->excludes(opt_count);
+    app.add_option("--batch", batch_file, "Solve one puzzle per line of the file ('-' for stdin), as JSON lines")
+        ->excludes(opt_left, opt_top, opt_right, opt_bottom, opt_count, opt_unique);
     app.callback(
         [&]
         {
@@ -53,28 +345,29 @@ int main(int argc, char** argv)
         });
     CLI11_PARSE(app, argc, argv);
 
-    auto const solve_and_print = []<class... Lists>(Lists&&... ls)
-    {
-        mirror_grid grid(std::forward<Lists>(ls)...);
-        auto const  n = grid.length();
-        fmt::println("Grid ({}*{}): {}", n, n, grid);
-        spdlog::info("Starting solving grid ({}*{})", n, n);
+    auto const mode = count ? run_mode::Count : (unique ? run_mode::Unique : run_mode::Solve);
 
-        mirror_grid_solver solver(grid);
-        bool const         is_solved = solver.solve();
-        spdlog::info("Finished grid ({}*{}). Solved={}", n, n, is_solved);
+    if(!batch_file.empty())
+    {
+        // Per-node debug logs would dominate a batch run.
+        spdlog::set_level(spdlog::level::info);
+        spdlog::info("Starting batch from {}", batch_file);
 
-        if(is_solved)
+        if(batch_file == "-")
+            solve_batch(std::cin, jobs);
+        else if(std::ifstream in(batch_file); in)
+            solve_batch(in, jobs);
+        else
         {
-            auto const res = grid.compute_result();
-            fmt::println("Left: {}, Top: {}, Right: {}, Bottom: {}, Product: {}", res.left, res.top, res.right,
-                         res.bottom, res.product);
-            fmt::println("Solved grid ({}*{}): {}", n, n, grid);
+            spdlog::error("Cannot open batch file {}", batch_file);
+            fmt::println(stderr, "Error: cannot open batch file {}", batch_file);
+            return 1;
         }
-        else
-            fmt::println("No solution found for grid ({}*{}): {}", n, n, grid);
-    };
+        return 0;
+    }
 
+    auto const solve_and_print = [&](auto const&... ls)
+    { with_grid([&](auto grid) { solve_and_print_grid(std::move(grid), mode, jobs); }, ls...); };
 
     if(opt_left->count() & opt_top->count() & opt_right->count() & opt_bottom->count())
     {
@@ -1,5 +1,12 @@
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <sys/types.h>
 #include <tuple>
 
@@ -11,16 +18,23 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <CLI/CLI.hpp>
 
+#include <tbb/task_arena.h>
+
+
+#include "2025/may/number_cross_checkpoint.h"
 #include "2025/may/number_cross_grid.h"
 #include "2025/may/number_cross_grid_predicates.h"
 #include "2025/may/number_cross_grid_solver.h"
+#include "2025/may/number_cross_puzzle.h"
+#include "2025/may/number_cross_runtime_predicates.h"
 
 
 template<size_t N>
 static void init_logging(char const (&log_file)[N])
 {
-    auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_st>(log_file, true);
+    auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file, true);
     file_sink->set_level(spdlog::level::info);
     auto logger = std::make_shared<spdlog::logger>("", file_sink);
     spdlog::set_default_logger(logger);
@@ -30,11 +44,178 @@ static void init_logging(char const (&log_file)[N])
 }
 
 
+// Grid sizes with a run-time predicate solver compiled in.
+static constexpr size_t kMinRuntimeSize = 3;
+static constexpr size_t kMaxRuntimeSize = 13;
+
+
+// Builds the grid of `puzzle` and hands it to `f`. Clues matching one of the `known` predicate tuples get that tuple's
+// solver, with every predicate inlined; other clues go through `any_row_predicate` on a grid of their size.
+template<class F, CTupleRowPredicates... Known>
+static void with_grid(number_cross_puzzle const& puzzle, F&& f, Known const&... known)
+{
+    auto const with_known = [&]<class Tuple>(Tuple const& predicates)
+    {
+        constexpr size_t N = std::tuple_size_v<Tuple>;
+        if(!puzzle.matches(predicates))
+            return false;
+
+        spdlog::info("Solving {}x{} puzzle with compiled-in predicates", N, N);
+        number_cross_grid grid(predicates, puzzle.region_array<N>(), puzzle.highlighted_array<N>());
+        f(grid);
+        return true;
+    };
+
+    if((with_known(known) || ...))
+        return;
+
+    auto const with_runtime = [&]<size_t... Is>(std::index_sequence<Is...>)
+    {
+        auto const with_size = [&]<size_t N>(std::integral_constant<size_t, N>)
+        {
+            if(puzzle.size() != N)
+                return false;
+
+            spdlog::info("Solving {}x{} puzzle with run-time predicates", N, N);
+            number_cross_grid grid(puzzle.clue_tuple<N>(), puzzle.region_array<N>(), puzzle.highlighted_array<N>());
+            f(grid);
+            return true;
+        };
+        return (with_size(std::integral_constant<size_t, kMinRuntimeSize + Is>{}) || ...);
+    };
+
+    if(!with_runtime(std::make_index_sequence<kMaxRuntimeSize - kMinRuntimeSize + 1>{}))
+        throw std::invalid_argument{
+            fmt::format("grid size {} is outside of {}-{}", puzzle.size(), kMinRuntimeSize, kMaxRuntimeSize)};
+}
+
+
 int main(int argc, char** argv)
 {
     init_logging("number_cross_5.log");
     spdlog::info("Starting number-cross-5");
 
+    int         jobs        = 0;
+    size_t      dead_end_mb = 64;
+    std::string stats_file;
+    std::string puzzle_file;
+    size_t      max_solutions = 1;
+    std::string checkpoint_file;
+    int         checkpoint_seconds = 60;
+    bool        resume             = false;
+
+    CLI::App app{"Number cross 5 solver"};
+    argv = app.ensure_utf8(argv);
+    app.add_option("-j,--jobs", jobs, "Worker threads for the region search (0: all cores, 1: serial)")
+        ->check(CLI::NonNegativeNumber);
+    app.add_option("--dead-end-mb", dead_end_mb, "Memory for row searches known to fail, in MiB (0: off)");
+    app.add_option("--puzzle", puzzle_file, "Solve the puzzle described in the file instead of the built-in ones");
+    app.add_option("--solutions", max_solutions,
+                   "Print solutions as they are found, up to this many (0: all, 2: check uniqueness); serial only");
+    app.add_option("--checkpoint", checkpoint_file,
+                   "Save the region search position to <file>.<grid> periodically, removed once the search ends");
+    app.add_option("--checkpoint-seconds", checkpoint_seconds, "Seconds between checkpoints")
+        ->check(CLI::PositiveNumber);
+    app.add_flag("--resume", resume, "Resume the region search from the checkpoint files, if any")
+        ->needs("--checkpoint");
+    app.add_option("--stats", stats_file, "Append search statistics as JSON lines (needs NUMBER_CROSS_STATS=1)");
+    CLI11_PARSE(app, argc, argv);
+
+    auto const dump_stats = [&](auto const& solver, std::string_view const label)
+    {
+        if(stats_file.empty())
+            return;
+        std::FILE* const out = std::fopen(stats_file.c_str(), "a");
+        if(out == nullptr)
+        {
+            spdlog::error("Cannot open stats file {}", stats_file);
+            return;
+        }
+        solver.get_stats().dump(out, label);
+        std::fclose(out);
+    };
+
+    auto const configure = [&](auto& solver, std::string_view const tag)
+    {
+        solver.set_dead_end_budget(dead_end_mb << 20);
+        if(checkpoint_file.empty())
+            return;
+
+        auto const path = fmt::format("{}.{}", checkpoint_file, tag);
+        solver.set_checkpoint(path, std::chrono::seconds{checkpoint_seconds});
+        if(!resume)
+            return;
+
+        try
+        {
+            if(auto const checkpoint = number_cross_checkpoint::load(path))
+            {
+                // The first solution of an enumeration lies before its checkpoint.
+                if(max_solutions == 1 && !checkpoint->reported.empty())
+                    throw std::invalid_argument{"saved while enumerating solutions, resume it with --solutions"};
+
+                solver.resume_after(*checkpoint);
+                if(!checkpoint->reported.empty())
+                    fmt::println("Resuming {} with {} solutions found before the checkpoint", path,
+                                 checkpoint->reported.size());
+            }
+        }
+        catch(std::invalid_argument const& e)
+        {
+            spdlog::error("Ignoring checkpoint {}: {}", path, e.what());
+            fmt::println(stderr, "Warning: ignoring checkpoint {}: {}", path, e.what());
+        }
+    };
+
+    auto const solve = [&](auto& solver, std::string_view const tag)
+    {
+        configure(solver, tag);
+        return (jobs == 1) ? solver.solve() : solver.solve_parallel(jobs == 0 ? tbb::task_arena::automatic : jobs);
+    };
+
+    auto const enumerate_and_print = [&](auto& grid, std::string_view const label, std::string_view const tag)
+    {
+        auto const limit = max_solutions == 0 ? std::numeric_limits<size_t>::max() : max_solutions;
+
+        number_cross_grid_solver solver(grid);
+        configure(solver, tag);
+        auto const found = solver.solve_all(
+            [&](auto const& solution, auto const& numbers)
+            {
+                fmt::println("\n{} solution:\n{:D}", label, solution);
+                fmt::println("{} unique numbers: {}, Sum: {}", label, numbers,
+                             std::ranges::fold_left(numbers, int64_t{}, std::plus<>{}));
+                std::fflush(stdout);
+                return true;
+            },
+            limit);
+        dump_stats(solver, label);
+
+        if(found == limit)
+            fmt::println("\n{}: stopped after {} solutions", label, found);
+        else
+            fmt::println("\n{}: {} solutions{}", label, found, found == 1 ? ", unique" : "");
+    };
+
+    auto const solve_and_print = [&](auto& grid, std::string_view const label)
+    {
+        if(max_solutions != 1)
+            return enumerate_and_print(grid, label, "puzzle");
+
+        number_cross_grid_solver solver(grid);
+        if(!solve(solver, "puzzle"))
+        {
+            fmt::println("\nNo solution for {}:\n{:R}", label, grid);
+            return;
+        }
+        dump_stats(solver, label);
+
+        fmt::println("\n{} with initial digits:\n{:R}", label, grid);
+        fmt::println("\n{} after placing tiles:\n{:D}", label, grid);
+        fmt::println("\n{} unique numbers: {}, Sum: {}", label, solver.get_unique_numbers(),
+                     std::ranges::fold_left(solver.get_unique_numbers(), int64_t{}, std::plus<>{}));
+    };
+
     // clang-format off
     constexpr CTupleRowPredicates auto preds5 = std::make_tuple(
         is_multiple_of<11>{},
@@ -59,17 +240,6 @@ int main(int argc, char** argv)
          {0, 0, 0, 1, 1}}};
     // clang-format on
 
-    number_cross_grid grid5(preds5, regions5, highlighted5);
-
-    number_cross_grid_solver solver5(grid5);
-    solver5.solve();
-
-    fmt::println("\nGrid 5 with initial digits:\n{:R}", grid5);
-    fmt::println("\nGrid 5 after placing tiles:\n{:D}", grid5);
-    fmt::println("\nGrid 5 unique numbers: {}, Sum: {}", solver5.get_unique_numbers(),
-                 std::ranges::fold_left(solver5.get_unique_numbers(), int64_t{}, std::plus<>{}));
-
-
     // clang-format off
     constexpr CTupleRowPredicates auto preds11 = std::make_tuple(
         is_perfect_square{},
@@ -114,6 +284,49 @@ int main(int argc, char** argv)
     constexpr auto grid_region_digits_hint11 = std::array<uint8_t, 9>{{2, 4, 3, 3, 4, 1, 6, 7, 7}};
     // clang-format on
 
+    if(!puzzle_file.empty())
+    {
+        std::ifstream in(puzzle_file);
+        if(!in)
+        {
+            spdlog::error("Cannot open puzzle file {}", puzzle_file);
+            fmt::println(stderr, "Error: cannot open puzzle file {}", puzzle_file);
+            return 1;
+        }
+
+        try
+        {
+            auto const puzzle = number_cross_puzzle::parse(in);
+            with_grid(puzzle, [&](auto& grid) { solve_and_print(grid, puzzle_file); }, preds5, preds11);
+        }
+        catch(std::invalid_argument const& e)
+        {
+            spdlog::error("Invalid puzzle file {}: {}", puzzle_file, e.what());
+            fmt::println(stderr, "Error: invalid puzzle file {}: {}", puzzle_file, e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    number_cross_grid grid5(preds5, regions5, highlighted5);
+    if(max_solutions != 1)
+    {
+        number_cross_grid grid11(preds11, regions11, highlighted11);
+        enumerate_and_print(grid5, "Grid 5", "grid5");
+        enumerate_and_print(grid11, "Grid 11", "grid11");
+        return 0;
+    }
+
+    number_cross_grid_solver solver5(grid5);
+    solve(solver5, "grid5");
+    dump_stats(solver5, "grid5");
+
+    fmt::println("\nGrid 5 with initial digits:\n{:R}", grid5);
+    fmt::println("\nGrid 5 after placing tiles:\n{:D}", grid5);
+    fmt::println("\nGrid 5 unique numbers: {}, Sum: {}", solver5.get_unique_numbers(),
+                 std::ranges::fold_left(solver5.get_unique_numbers(), int64_t{}, std::plus<>{}));
+
+
     // number_cross_grid        grid11_hint(preds11, regions11, highlighted11);
     // number_cross_grid_solver solver11_hint(grid11_hint);
     // solver11_hint.solve_with_region_digits(grid_region_digits_hint11);
@@ -125,7 +338,8 @@ int main(int argc, char** argv)
 
     number_cross_grid        grid11(preds11, regions11, highlighted11);
     number_cross_grid_solver solver11(grid11);
-    solver11.solve();
+    solve(solver11, "grid11");
+    dump_stats(solver11, "grid11");
 
     fmt::println("\nGrid 11 with initial digits:\n{:R}", grid11);
     fmt::println("\nGrid 11 after placing tiles:\n{}", grid11);
@@ -0,0 +1,181 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "2025/may/number_cross_grid_predicates.h"
+
+
+// The kernels the predicates used before, kept as the baseline.
+namespace legacy
+{
+
+static auto mul_mod(uint64_t const x, uint64_t const y, uint64_t const m) noexcept -> uint64_t
+{
+    return (static_cast<__uint128_t>(x) * y) % m;
+}
+
+static auto pow_mod(uint64_t base, uint64_t exp, uint64_t const mod) noexcept -> uint64_t
+{
+    uint64_t result = 1;
+    uint64_t cur    = base % mod;
+    for(; exp > 0; exp >>= 1)
+    {
+        if(exp & 1)
+            result = mul_mod(result, cur, mod);
+        cur = mul_mod(cur, cur, mod);
+    }
+    return result;
+}
+
+static auto miller_rabin_test(uint64_t const n, uint64_t const a) noexcept -> bool
+{
+    if(n % a == 0)
+        return false;
+    uint64_t d = n - 1;
+    int      r = 0;
+    for(; (d & 1) == 0; d >>= 1)
+        ++r;
+    uint64_t x = pow_mod(a, d, n);
+    if(x == 1 || x == n - 1)
+        return true;
+    for(int i = 1; i < r; ++i)
+    {
+        x = mul_mod(x, x, n);
+        if(x == n - 1)
+            return true;
+    }
+    return false;
+}
+
+static auto is_prime(int64_t const x) noexcept -> bool
+{
+    if(x < 2)
+        return false;
+    for(auto const p: {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47})
+    {
+        if(x == p)
+            return true;
+        if(x % p == 0)
+            return false;
+    }
+    for(auto const b: {2, 325, 9375, 28178, 450775, 9780504, 1795265022})
+    {
+        if(b % x == 0)
+            return true;
+        if(!miller_rabin_test(x, b))
+            return false;
+    }
+    return true;
+}
+
+static auto is_perfect_square(int64_t const x) noexcept -> bool
+{
+    auto const s = static_cast<int64_t>(std::sqrt(static_cast<double>(x)));
+    return s * s == x || (s + 1) * (s + 1) == x;
+}
+
+} // namespace legacy
+
+
+// Batches of `len`-digit numbers made of digits 1-9, like the rows the candidate tables enumerate.
+static auto make_batches(size_t const len, bool const odd_only) -> std::vector<row_batch>
+{
+    std::mt19937_64                        rng{2025};
+    std::uniform_int_distribution<uint8_t> digit{1, 9};
+
+    std::vector<row_batch> res(1024);
+    for(auto& batch: res)
+    {
+        batch.len  = len;
+        batch.size = row_batch::kLanes;
+        for(size_t i = 0; i < row_batch::kLanes; ++i)
+        {
+            int64_t x = 0;
+            for(size_t k = 0; k < len; ++k)
+            {
+                auto d = digit(rng);
+                if(odd_only && k + 1 == len)
+                    d |= 1;
+                batch.digits[k][i] = d;
+                x                  = 10 * x + d;
+            }
+            batch.numbers[i] = x;
+        }
+    }
+    return res;
+}
+
+// Whole batches, as the candidate tables check them.
+template<class Check>
+static void run_batches(benchmark::State& state, bool const odd_only, Check&& check)
+{
+    auto const           batches = make_batches(state.range(0), odd_only);
+    row_batch::lane_flags out{};
+    for(auto _: state)
+    {
+        for(auto const& batch: batches)
+        {
+            check(batch, out);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batches.size() * row_batch::kLanes);
+}
+
+// One number at a time, as rows too long to index are checked during the search. The search branches on every result
+// before the next check, so each input depends on the previous results and latency is what gets measured.
+template<class Check>
+static void run_numbers(benchmark::State& state, bool const odd_only, Check&& check)
+{
+    auto const batches = make_batches(state.range(0), odd_only);
+    for(auto _: state)
+    {
+        int64_t found = 0;
+        for(auto const& batch: batches)
+            for(auto const x: batch.numbers)
+                found += check(x + (found & 1));
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * batches.size() * row_batch::kLanes);
+}
+
+
+static void BM_is_prime_legacy(benchmark::State& state)
+{
+    run_batches(state, true,
+                [](row_batch const& batch, row_batch::lane_flags& out)
+                {
+                    for(size_t i = 0; i < row_batch::kLanes; ++i)
+                        out[i] = legacy::is_prime(batch.numbers[i]);
+                });
+}
+
+static void BM_is_prime(benchmark::State& state)
+{
+    run_batches(state, true,
+                [](row_batch const& batch, row_batch::lane_flags& out) { is_prime{}.check_batch(batch, out); });
+}
+
+// Squares are rare, so adding the previous result barely changes the inputs.
+static void BM_is_perfect_square_legacy(benchmark::State& state)
+{
+    run_numbers(state, false, [](int64_t const x) { return legacy::is_perfect_square(x); });
+}
+
+static void BM_is_perfect_square(benchmark::State& state)
+{
+    run_numbers(state, false, [](int64_t const x) { return square_root::is_square(x); });
+}
+
+
+// Row lengths of the 5x5 example, of the 11x11 puzzle, and the longest a 16x16 grid can hold.
+BENCHMARK(BM_is_prime_legacy)->Arg(5)->Arg(11)->Arg(16);
+BENCHMARK(BM_is_prime)->Arg(5)->Arg(11)->Arg(16);
+BENCHMARK(BM_is_perfect_square_legacy)->Arg(5)->Arg(11)->Arg(16);
+BENCHMARK(BM_is_perfect_square)->Arg(5)->Arg(11)->Arg(16);
+
+BENCHMARK_MAIN();
@@ -2,6 +2,8 @@
 #define NUMBER_CROSS_PARTITIONS_H
 
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <span>
 
 struct grid_cross_partition
@@ -12,30 +14,75 @@ struct grid_cross_partition
     uint8_t bottom;
 };
 
+// Sides of a tile its displaced digit cannot go to: off the grid, highlighted or blocked.
+enum grid_cross_side : uint8_t
+{
+    kLeftSide   = 1,
+    kTopSide    = 2,
+    kRightSide  = 4,
+    kBottomSide = 8,
+};
+
 struct grid_cross_partitions_generator
 {
-    template<int Digit>
-    static constexpr auto compute()
-    {
-        constexpr size_t kElements = (Digit + 1) * (Digit + 2) * (Digit + 3) / 6;
+    static constexpr size_t kClosedMasks = 16;
 
-        std::array<grid_cross_partition, kElements> res{};
+    // Partitions of every digit for every mask of closed sides, stored back to back: those of `digit` with closed
+    // sides `mask` are partitions[offsets[digit][mask]] up to partitions[offsets[digit][mask + 1]].
+    template<size_t Size>
+    struct table
+    {
+        std::array<grid_cross_partition, Size>                 partitions{};
+        std::array<std::array<uint16_t, kClosedMasks + 1>, 10> offsets{};
+    };
 
-        int const dig = Digit;
+    // Visits the partitions of `digit` leaving the sides in `closed` empty, in the same order for every mask.
+    template<class F>
+    static constexpr void for_each(int const digit, uint8_t const closed, F&& f)
+    {
+        if(digit == 0)
+            return;
 
-        size_t count = 0;
-        for(int l = 0; l <= dig; ++l)
-            for(int t = 0; t <= dig - l; ++t)
-                for(int r = 0; r <= dig - l - t; ++r)
+        for(int l = 0; l <= digit; ++l)
+            for(int t = 0; t <= digit - l; ++t)
+                for(int r = 0; r <= digit - l - t; ++r)
                 {
-                    grid_cross_partition& part = res[count];
+                    grid_cross_partition const part{.left   = uint8_t(l),
+                                                    .top    = uint8_t(t),
+                                                    .right  = uint8_t(r),
+                                                    .bottom = uint8_t(digit - l - t - r)};
 
-                    part.left   = l;
-                    part.top    = t;
-                    part.right  = r;
-                    part.bottom = dig - l - t - r;
-                    ++count;
+                    bool const is_open = !((closed & kLeftSide) && part.left) && !((closed & kTopSide) && part.top) &&
+                                         !((closed & kRightSide) && part.right) &&
+                                         !((closed & kBottomSide) && part.bottom);
+                    if(is_open)
+                        f(part);
                 }
+    }
+
+    static constexpr size_t size()
+    {
+        size_t res = 0;
+        for(int digit = 0; digit < 10; ++digit)
+            for(uint8_t mask = 0; mask < kClosedMasks; ++mask)
+                for_each(digit, mask, [&](auto) { ++res; });
+        return res;
+    }
+
+    static constexpr auto compute()
+    {
+        table<size()> res{};
+
+        uint16_t count = 0;
+        for(int digit = 0; digit < 10; ++digit)
+        {
+            for(uint8_t mask = 0; mask < kClosedMasks; ++mask)
+            {
+                res.offsets[digit][mask] = count;
+                for_each(digit, mask, [&](auto const part) { res.partitions[count++] = part; });
+            }
+            res.offsets[digit][kClosedMasks] = count;
+        }
 
         return res;
     }
@@ -43,23 +90,25 @@ struct grid_cross_partitions_generator
 
 struct grid_cross_partitions
 {
-    static constexpr auto& get(int number) { return cell_partitions_[number]; }
+    // Partitions of `digit` over the sides not in `closed`.
+    static constexpr auto get(int const digit, uint8_t const closed = 0) noexcept
+    {
+        auto const first = table_.offsets[digit][closed];
+        auto const last  = table_.offsets[digit][closed + 1];
+        return std::span<grid_cross_partition const>(table_.partitions).subspan(first, last - first);
+    }
+
+    // Whether no side of `part` exceeds its `headroom`, comparing the four bytes at once. Both hold values up to 9, so
+    // subtracting a part from its headroom with the high bit set clears that bit only when the part is too large.
+    static constexpr bool fits(grid_cross_partition const part, grid_cross_partition const headroom) noexcept
+    {
+        auto const p = std::bit_cast<uint32_t>(part);
+        auto const h = std::bit_cast<uint32_t>(headroom);
+        return (((h | 0x80808080u) - p) & 0x80808080u) == 0x80808080u;
+    }
 
 private:
-    static constexpr auto zero_partitions_  = std::array<grid_cross_partition, 0>{};
-    static constexpr auto one_partitions_   = grid_cross_partitions_generator::compute<1>();
-    static constexpr auto two_partitions_   = grid_cross_partitions_generator::compute<2>();
-    static constexpr auto three_partitions_ = grid_cross_partitions_generator::compute<3>();
-    static constexpr auto four_partitions_  = grid_cross_partitions_generator::compute<4>();
-    static constexpr auto five_partitions_  = grid_cross_partitions_generator::compute<5>();
-    static constexpr auto six_partitions_   = grid_cross_partitions_generator::compute<6>();
-    static constexpr auto seven_partitions_ = grid_cross_partitions_generator::compute<7>();
-    static constexpr auto eight_partitions_ = grid_cross_partitions_generator::compute<8>();
-    static constexpr auto nine_partitions_  = grid_cross_partitions_generator::compute<9>();
-
-    static constexpr auto cell_partitions_ = std::array<std::span<grid_cross_partition const>, 10>{
-        zero_partitions_, one_partitions_, two_partitions_,   three_partitions_, four_partitions_,
-        five_partitions_, six_partitions_, seven_partitions_, eight_partitions_, nine_partitions_};
+    static constexpr auto table_ = grid_cross_partitions_generator::compute();
 };
 
 
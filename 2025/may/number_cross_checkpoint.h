@@ -0,0 +1,108 @@
+#ifndef NUMBER_CROSS_CHECKPOINT_H
+#define NUMBER_CROSS_CHECKPOINT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+
+// Position of a region search: the last region configuration searched without a solution, in the search order, and
+// the grids an enumeration reported up to there. The file is a header line, the grid size, region count and puzzle
+// fingerprint, the region digits, then the count of reported grids followed by the packed digit rows of each one, in
+// hex:
+//
+//     number_cross_checkpoint 2
+//     11 9 8f3a61c0d2e4b597
+//     2 4 3 3 4 1 6 7 7
+//     1
+//     204003 ... 1160
+struct number_cross_checkpoint
+{
+    size_t                             grid_size{0};
+    uint64_t                           fingerprint{0};
+    std::vector<uint8_t>               region_digits{};
+    std::vector<std::vector<uint64_t>> reported{};
+
+    // Writes next to `path` and renames over it, so an interrupted write leaves the previous checkpoint intact.
+    bool save(std::filesystem::path const& path) const
+    {
+        auto tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::trunc);
+            out << fmt::format("{} {}\n{} {} {:x}\n{}\n{}\n", kHeader, kVersion, grid_size, region_digits.size(),
+                               fingerprint, fmt::join(region_digits, " "), reported.size());
+            for(auto const& rows: reported)
+                out << fmt::format("{:x}\n", fmt::join(rows, " "));
+            if(!out.flush())
+                return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        return !ec;
+    }
+
+    // Nothing when there is no checkpoint yet; throws std::invalid_argument when the file is not one.
+    static std::optional<number_cross_checkpoint> load(std::filesystem::path const& path)
+    {
+        std::ifstream in(path);
+        if(!in)
+            return std::nullopt;
+
+        number_cross_checkpoint res;
+        std::string             header;
+        int                     version    = 0;
+        size_t                  regions_sz = 0;
+        if(!(in >> header >> version >> res.grid_size >> regions_sz >> std::hex >> res.fingerprint >> std::dec) ||
+           header != kHeader || version != kVersion)
+            throw std::invalid_argument{fmt::format("{} is not a checkpoint", path.string())};
+
+        for(size_t idx = 0; idx < regions_sz; ++idx)
+        {
+            int digit = 0;
+            if(!(in >> digit) || digit < 1 || digit > 9)
+                throw std::invalid_argument{fmt::format("{}: invalid digit for region {}", path.string(), idx)};
+            res.region_digits.push_back(digit);
+        }
+
+        size_t reported_sz = 0;
+        if(!(in >> reported_sz))
+            throw std::invalid_argument{fmt::format("{}: missing count of reported grids", path.string())};
+
+        for(size_t idx = 0; idx < reported_sz; ++idx)
+        {
+            auto& rows = res.reported.emplace_back();
+            for(size_t r = 0; r < res.grid_size; ++r)
+            {
+                uint64_t row = 0;
+                if(!(in >> std::hex >> row >> std::dec))
+                    throw std::invalid_argument{fmt::format("{}: invalid row of reported grid {}", path.string(), idx)};
+                rows.push_back(row);
+            }
+        }
+        return res;
+    }
+
+    static void remove(std::filesystem::path const& path) noexcept
+    {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+private:
+    static constexpr auto kHeader  = "number_cross_checkpoint";
+    static constexpr int  kVersion = 2;
+};
+
+
+#endif // NUMBER_CROSS_CHECKPOINT_H
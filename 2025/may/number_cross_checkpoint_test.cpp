@@ -0,0 +1,205 @@
+#include "2025/may/number_cross_checkpoint.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "2025/may/number_cross_grid.h"
+#include "2025/may/number_cross_grid_predicates.h"
+#include "2025/may/number_cross_grid_solver.h"
+
+
+namespace
+{
+
+// The 5x5 example board, whose unique solution is known.
+// clang-format off
+constexpr auto kPredicates5 = std::make_tuple(
+    is_multiple_of<11>{},
+    is_multiple_of<14>{},
+    is_multiple_of<28>{},
+    is_multiple_of<101>{},
+    is_multiple_of<2025>{}
+);
+
+constexpr auto kRegions5 = std::array<std::array<uint8_t, 5>, 5>{
+    {{0, 0, 0, 0, 0},
+     {1, 0, 0, 0, 0},
+     {1, 1, 0, 0, 0},
+     {2, 1, 1, 0, 0},
+     {2, 2, 1, 1, 0}}};
+
+constexpr auto kHighlighted5 = std::array<std::array<bool, 5>, 5>{
+    {{1, 1, 0, 0, 0},
+     {1, 0, 0, 0, 0},
+     {0, 0, 0, 0, 0},
+     {0, 0, 0, 0, 1},
+     {0, 0, 0, 1, 1}}};
+// clang-format on
+
+class NumberCrossCheckpointTest : public testing::Test
+{
+protected:
+    std::filesystem::path const path_ = std::filesystem::temp_directory_path() /
+                                        (std::string{testing::UnitTest::GetInstance()->current_test_info()->name()} +
+                                         ".checkpoint");
+
+    void TearDown() override { number_cross_checkpoint::remove(path_); }
+
+    void write_(std::string const& contents) const { std::ofstream(path_) << contents; }
+};
+
+template<class Grid>
+std::vector<uint8_t> region_digits_of(Grid const& grid)
+{
+    std::vector<uint8_t> res;
+    for(auto const& region: grid.regions())
+        res.push_back(region.get_digit());
+    return res;
+}
+
+} // namespace
+
+
+TEST_F(NumberCrossCheckpointTest, SavesAndLoads)
+{
+    number_cross_checkpoint const checkpoint{11, 0x8f3a61c0d2e4b597, {2, 4, 3, 3, 4, 1, 6, 7, 7}, {{}, {}}};
+    auto                          saved = checkpoint;
+    saved.reported[0].assign(11, 0x204003);
+    saved.reported[1].assign(11, 0xffffffffffffffff);
+
+    ASSERT_TRUE(saved.save(path_));
+    EXPECT_FALSE(std::filesystem::exists(path_.string() + ".tmp"));
+
+    auto const loaded = number_cross_checkpoint::load(path_);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->grid_size, saved.grid_size);
+    EXPECT_EQ(loaded->fingerprint, saved.fingerprint);
+    EXPECT_EQ(loaded->region_digits, saved.region_digits);
+    EXPECT_EQ(loaded->reported, saved.reported);
+}
+
+TEST_F(NumberCrossCheckpointTest, MissingFileIsNoCheckpoint)
+{
+    EXPECT_FALSE(number_cross_checkpoint::load(path_));
+}
+
+TEST_F(NumberCrossCheckpointTest, RejectsMalformedFiles)
+{
+    for(std::string const contents: {
+            "",
+            "number_cross_checkpoint 1\n3 3\n1 2 3\n0\n",
+            "number_cross_checkpoint 2\n3 3\n1 2 3\n0\n",
+            "not_a_checkpoint 2\n3 3 ab\n1 2 3\n0\n",
+            "number_cross_checkpoint 2\n3 3 ab\n1 0 3\n0\n",
+            "number_cross_checkpoint 2\n3 3 ab\n1 2 10\n0\n",
+            "number_cross_checkpoint 2\n3 3 ab\n1 2\n",
+            "number_cross_checkpoint 2\n3 3 ab\n1 2 3\n",
+            "number_cross_checkpoint 2\n3 3 ab\n1 2 3\n1\n12 34\n",
+            "number_cross_checkpoint 2\n3 3 ab\n1 2 3\n1\n12 34 xyz\n",
+        })
+    {
+        SCOPED_TRACE(contents);
+        write_(contents);
+        EXPECT_THROW(number_cross_checkpoint::load(path_), std::invalid_argument);
+    }
+}
+
+TEST_F(NumberCrossCheckpointTest, FingerprintTellsPuzzlesApart)
+{
+    auto other_highlighted  = kHighlighted5;
+    other_highlighted[2][2] = true;
+    auto other_regions      = kRegions5;
+    other_regions[4][1]     = 1;
+
+    auto const other_predicates = std::make_tuple(is_multiple_of<12>{}, is_multiple_of<14>{}, is_multiple_of<28>{},
+                                                  is_multiple_of<101>{}, is_multiple_of<2025>{});
+
+    number_cross_grid const grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid const same_grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid const other_clues(other_predicates, kRegions5, kHighlighted5);
+    number_cross_grid const other_highlighting(kPredicates5, kRegions5, other_highlighted);
+    number_cross_grid const other_layout(kPredicates5, other_regions, kHighlighted5);
+
+    EXPECT_EQ(grid.fingerprint(), same_grid.fingerprint());
+    EXPECT_NE(grid.fingerprint(), other_clues.fingerprint());
+    EXPECT_NE(grid.fingerprint(), other_highlighting.fingerprint());
+    EXPECT_NE(grid.fingerprint(), other_layout.fingerprint());
+}
+
+TEST_F(NumberCrossCheckpointTest, ResumesAfterTheSolution)
+{
+    number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+    ASSERT_TRUE(solver.solve());
+
+    number_cross_checkpoint const checkpoint{5, grid.fingerprint(), region_digits_of(grid)};
+    ASSERT_TRUE(checkpoint.save(path_));
+    auto const loaded = number_cross_checkpoint::load(path_);
+    ASSERT_TRUE(loaded);
+
+    // The solution is unique, so nothing is left after its configuration.
+    number_cross_grid        resumed_grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver resumed(resumed_grid);
+    resumed.resume_after(*loaded);
+    EXPECT_EQ(resumed.solve_all([](auto const&, auto const&) { return true; }), 0);
+}
+
+TEST_F(NumberCrossCheckpointTest, RejectsCheckpointOfAnotherPuzzle)
+{
+    number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+    ASSERT_TRUE(solver.solve());
+
+    auto other_highlighted  = kHighlighted5;
+    other_highlighted[2][2] = true;
+    number_cross_grid other_grid(kPredicates5, kRegions5, other_highlighted);
+
+    number_cross_checkpoint const checkpoint{5, other_grid.fingerprint(), region_digits_of(grid)};
+
+    number_cross_grid        resumed_grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver resumed(resumed_grid);
+    EXPECT_THROW(resumed.resume_after(checkpoint), std::invalid_argument);
+    EXPECT_THROW(resumed.resume_after({4, grid.fingerprint(), region_digits_of(grid)}), std::invalid_argument);
+    EXPECT_THROW(resumed.resume_after({5, grid.fingerprint(), {1, 2}}), std::invalid_argument);
+}
+
+TEST_F(NumberCrossCheckpointTest, RejectsDigitsTheSearchCannotReach)
+{
+    // Region 0 has highlighted cells in the first row, whose digits have to divide 16.
+    auto const predicates = std::make_tuple(product_of_digits_matches<16>{}, is_multiple_of<14>{}, is_multiple_of<28>{},
+                                            is_multiple_of<101>{}, is_multiple_of<2025>{});
+
+    number_cross_grid        grid(predicates, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+
+    std::vector<uint8_t> const digits{2, 1, 2};
+    ASSERT_NO_THROW(solver.resume_after({5, grid.fingerprint(), digits}));
+
+    // Regions 0 and 1 touch, so they cannot share a digit.
+    EXPECT_THROW(solver.resume_after({5, grid.fingerprint(), {2, 2, 1}}), std::invalid_argument);
+
+    size_t outside = 0;
+    for(size_t idx = 0; idx < digits.size(); ++idx)
+    {
+        for(uint8_t d = 1; d < 10; ++d)
+        {
+            if(grid.regions()[idx].get_allowed_digits()[d])
+                continue;
+
+            SCOPED_TRACE(testing::Message() << "region " << idx << ", digit " << int(d));
+            auto other_digits = digits;
+            other_digits[idx] = d;
+            EXPECT_THROW(solver.resume_after({5, grid.fingerprint(), other_digits}), std::invalid_argument);
+            ++outside;
+        }
+    }
+    EXPECT_GE(outside, 5);
+}
@@ -0,0 +1,129 @@
+#ifndef NUMBER_CROSS_DEAD_ENDS_H
+#define NUMBER_CROSS_DEAD_ENDS_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+
+// Search states known to have no completion, evicted least recently used first once `budget` bytes are taken. A key
+// holds up to `Words` packed words describing the state; unused trailing words are zero.
+template<size_t Words>
+class dead_end_table
+{
+public:
+    using key_type = std::array<uint64_t, Words>;
+
+    explicit dead_end_table(size_t const budget = 0) { set_budget(budget); }
+
+    void set_budget(size_t const budget)
+    {
+        capacity_ = budget / kEntryBytes;
+        clear();
+    }
+
+    constexpr bool enabled() const noexcept { return capacity_ > 0; }
+
+    // Whether `key` is a known dead-end, marking it as the most recently used.
+    bool contains(key_type const& key)
+    {
+        auto const it = index_.find(key);
+        if(it == index_.end())
+            return false;
+
+        ++hits_;
+        unlink_(it->second);
+        link_front_(it->second);
+        return true;
+    }
+
+    void insert(key_type const& key)
+    {
+        if(!enabled() || index_.contains(key))
+            return;
+
+        uint32_t slot;
+        if(entries_.size() < capacity_)
+        {
+            slot = static_cast<uint32_t>(entries_.size());
+            entries_.emplace_back();
+        }
+        else
+        {
+            slot = tail_;
+            unlink_(slot);
+            index_.erase(entries_[slot].key);
+            ++evictions_;
+        }
+
+        entries_[slot].key = key;
+        index_.emplace(key, slot);
+        link_front_(slot);
+    }
+
+    void clear()
+    {
+        entries_.clear();
+        index_.clear();
+        head_ = tail_ = kNone;
+    }
+
+    constexpr size_t size() const noexcept { return index_.size(); }
+    constexpr size_t hits() const noexcept { return hits_; }
+    constexpr size_t evictions() const noexcept { return evictions_; }
+
+private:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    struct entry
+    {
+        key_type key{};
+        uint32_t prev{kNone};
+        uint32_t next{kNone};
+    };
+
+    struct key_hash
+    {
+        constexpr size_t operator()(key_type const& key) const noexcept
+        {
+            uint64_t h = 0;
+            for(auto const w: key)
+                h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+            return h ^ (h >> 32);
+        }
+    };
+
+    // An entry plus its index node, roughly.
+    static constexpr size_t kEntryBytes = sizeof(entry) + sizeof(key_type) + 4 * sizeof(void*);
+
+    void unlink_(uint32_t const slot) noexcept
+    {
+        auto& e = entries_[slot];
+        (e.prev == kNone ? head_ : entries_[e.prev].next) = e.next;
+        (e.next == kNone ? tail_ : entries_[e.next].prev) = e.prev;
+    }
+
+    void link_front_(uint32_t const slot) noexcept
+    {
+        auto& e = entries_[slot];
+        e.prev  = kNone;
+        e.next  = head_;
+        (head_ == kNone ? tail_ : entries_[head_].prev) = slot;
+        head_                                           = slot;
+    }
+
+    std::vector<entry>                             entries_{};
+    std::unordered_map<key_type, uint32_t, key_hash> index_{};
+
+    size_t   capacity_{0};
+    uint32_t head_{kNone};
+    uint32_t tail_{kNone};
+
+    size_t hits_{0};
+    size_t evictions_{0};
+};
+
+
+#endif // NUMBER_CROSS_DEAD_ENDS_H
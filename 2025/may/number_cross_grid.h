@@ -19,6 +19,7 @@
 #include <spdlog/spdlog.h>
 
 #include "2025/may/number_cross_grid_predicates.h"
+#include "2025/may/number_cross_runtime_predicates.h"
 #include "utils/base.h"
 
 
@@ -89,27 +90,62 @@ public:
 
     using grid_region = number_cross_grid_region<kMaxRegionSize, kMaxNeighbors>;
 
+    // A row packs one digit per nibble and one blocked flag per bit.
+    using row_mask = uint16_t;
+
+    static_assert(N <= 16, "a row of digits has to fit in one 64-bit word");
+
+    // Everything that changes in a row while placing tiles, small enough to be saved and restored as a whole.
+    struct row_state
+    {
+        uint64_t digits;
+        row_mask blocked;
+    };
+
     constexpr explicit number_cross_grid(std::tuple<Predicates...> const&             predicates,
                                          std::array<std::array<uint8_t, N>, N> const& region_index_map,
                                          std::array<std::array<bool, N>, N> const&    highlighted) noexcept
         : grid_regions_(std::ranges::max(region_index_map | std::views::join) + 1),
+          rows_{},
           highlighted_{},
-          blocked_{},
           predicates_{predicates},
           allowed_digits_{},
-          digits_{},
           region_index_{region_index_map}
     {
         for(int r = 0; r < N; ++r)
             for(int c = 0; c < N; ++c)
-                highlighted_[to_idx_(r, c)] = highlighted[r][c];
+                highlighted_[r] |= row_mask{highlighted[r][c]} << c;
 
         init_allowed_digits_();
         init_regions_();
     }
 
-    constexpr uint8_t&       operator()(int r, int c) noexcept { return digits_[r][c]; }
-    constexpr uint8_t const& operator()(int r, int c) const noexcept { return digits_[r][c]; }
+    constexpr uint8_t operator()(int r, int c) const noexcept { return (rows_[r].digits >> (4 * c)) & 0xF; }
+
+    constexpr void set_digit(int r, int c, uint8_t digit) noexcept
+    {
+        rows_[r].digits = (rows_[r].digits & ~(uint64_t{0xF} << (4 * c))) | (uint64_t{digit} << (4 * c));
+    }
+
+    // Digits never exceed 9, so the increment cannot carry into the next cell.
+    constexpr void add_digit(int r, int c, uint8_t increment) noexcept
+    {
+        rows_[r].digits += uint64_t{increment} << (4 * c);
+    }
+
+    // Unpacks `out.size()` digits of row `r` starting at column `start_col`.
+    constexpr void unpack_digits(int r, int start_col, std::span<uint8_t> out) const noexcept
+    {
+        auto packed = rows_[r].digits >> (4 * start_col);
+        for(auto& d: out)
+        {
+            d = packed & 0xF;
+            packed >>= 4;
+        }
+    }
+
+    constexpr row_state const& row(int r) const noexcept { return rows_[r]; }
+    constexpr void              set_row(int r, row_state const& state) noexcept { rows_[r] = state; }
 
     constexpr std::vector<grid_region>&       regions() noexcept { return grid_regions_; }
     constexpr std::vector<grid_region> const& regions() const noexcept { return grid_regions_; }
@@ -120,14 +156,15 @@ public:
     // clang-format off
     template<size_t Row>
     constexpr auto predicate() const noexcept -> decltype(auto) { return std::get<Row>(predicates_); }
-
-    template<size_t Row>
-    constexpr std::span<uint8_t const> row() const noexcept { return std::get<Row>(digits_); }
     // clang-format on
 
-    constexpr auto highlighted(int r, int c) const noexcept { return highlighted_[to_idx_(r, c)]; }
-    constexpr auto blocked(int r, int c) noexcept { return blocked_[to_idx_(r, c)]; }
-    constexpr auto blocked(int r, int c) const noexcept { return blocked_[to_idx_(r, c)]; }
+    constexpr bool highlighted(int r, int c) const noexcept { return (highlighted_[r] >> c) & 1; }
+    constexpr bool blocked(int r, int c) const noexcept { return (rows_[r].blocked >> c) & 1; }
+
+    constexpr void set_blocked(int r, int c, bool blocked) noexcept
+    {
+        rows_[r].blocked = (rows_[r].blocked & ~(row_mask{1} << c)) | (row_mask{blocked} << c);
+    }
 
     constexpr bool altered(int r, int c) const noexcept
     {
@@ -137,23 +174,51 @@ public:
 
     constexpr std::bitset<10> allowed_digits(int r) const noexcept { return allowed_digits_[r]; }
 
-    constexpr std::array<std::array<uint8_t, N>, N> const& digits_array() const noexcept { return digits_; }
     constexpr std::array<std::array<uint8_t, N>, N> const& region_index_array() const noexcept { return region_index_; }
 
+    // FNV-1a hash of the clues, the regions and the highlighted cells: what tells one puzzle of size N from another.
+    constexpr uint64_t fingerprint() const noexcept
+    {
+        uint64_t   hash = 0xcbf29ce484222325;
+        auto const mix  = [&](uint64_t const value)
+        {
+            for(int byte = 0; byte < 8; ++byte)
+                hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 0x100000001b3;
+        };
+
+        mix(N);
+        std::apply(
+            [&](auto const&... preds)
+            {
+                for(auto const& clue: {any_row_predicate::of(preds)...})
+                {
+                    mix(static_cast<uint64_t>(clue.type));
+                    mix(clue.parameter);
+                }
+            },
+            predicates_);
+        for(int r = 0; r < N; ++r)
+        {
+            for(int c = 0; c < N; ++c)
+                mix(region_index_[r][c]);
+            mix(highlighted_[r]);
+        }
+        return hash;
+    }
+
 private:
     template<CRowPredicate... Preds>
     friend class number_cross_grid_solver;
 
     std::vector<grid_region> grid_regions_{};
 
-    std::bitset<N * N> highlighted_{};
-    std::bitset<N * N> blocked_{};
+    std::array<row_state, N> rows_{};
+    std::array<row_mask, N>  highlighted_{};
 
     std::tuple<Predicates...> predicates_{};
 
     std::array<uint16_t, N> allowed_digits_{};
 
-    std::array<std::array<uint8_t, N>, N> digits_{};
     std::array<std::array<uint8_t, N>, N> region_index_{};
 
 
@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <bitset>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <ranges>
@@ -30,6 +32,47 @@ concept CTupleRowPredicates = requires {
         std::make_index_sequence<std::tuple_size_v<Tuple>>{});
 };
 
+// Predicates that can tell whether a number starting with `prefix` and growing by 1 to `remaining_len` digits may
+// still be valid. Answering true when unsure is always correct.
+template<class Pred>
+concept CPrefixRowPredicate =
+    CRowPredicate<Pred> && requires(Pred pred, std::span<uint8_t const> prefix, size_t remaining_len) {
+        { pred.can_extend(prefix, remaining_len) } -> std::same_as<bool>;
+    };
+
+// Automaton states fit 32 bits for every predicate, so the solver can carry them row by row in one array.
+using automaton_state                       = uint32_t;
+inline constexpr automaton_state kDeadState = ~automaton_state{0};
+
+// Predicates compiled into finite automata over digits: a number is valid when feeding its digits to `next_state`,
+// starting from `initial_state()`, ends in an accepted state. `can_extend_from` tells whether 1 to `remaining_len` more
+// digits may still reach one. Any transition can return kDeadState, which is never passed back.
+template<class Pred>
+concept CAutomatonRowPredicate =
+    CRowPredicate<Pred> && requires(Pred pred, automaton_state state, uint8_t digit, size_t remaining_len) {
+        { pred.initial_state() } -> std::same_as<automaton_state>;
+        { pred.next_state(state, digit) } -> std::same_as<automaton_state>;
+        { pred.accepts(state) } -> std::same_as<bool>;
+        { pred.can_extend_from(state, remaining_len) } -> std::same_as<bool>;
+    };
+
+
+// Up to kLanes numbers of the same length, stored digit by digit: digits[k][i] is the k-th digit of numbers[i]. Lanes
+// past `size` hold leftovers, which checks may process but whose results are ignored.
+struct row_batch
+{
+    static constexpr size_t kLanes     = 16;
+    static constexpr size_t kMaxDigits = 18;
+
+    using lane_flags = std::array<bool, kLanes>;
+
+    std::array<std::array<uint8_t, kLanes>, kMaxDigits> digits{};
+    std::array<int64_t, kLanes>                         numbers{};
+
+    size_t len{0};
+    size_t size{0};
+};
+
 
 template<class Derived>
 struct row_predicate
@@ -44,33 +87,162 @@ struct row_predicate
         if(!all_digit_valid)
             return {false, 0};
 
-        auto const x = std::ranges::fold_left(digits, int64_t{}, [](auto acc, auto c) { return 10 * acc + c; });
+        auto const x = to_number(digits);
 
         return {self().check(x, digits), x};
     }
 
     constexpr auto allowed_digits() const noexcept -> std::bitset<10> { return 0b1111111110; }
 
+    // Checks every lane of a batch of allowed-digit numbers. Predicates override it with lane by lane loops the
+    // compiler can vectorize; by default each number goes through `check`.
+    constexpr void check_batch(row_batch const& batch, row_batch::lane_flags& out) const noexcept
+    {
+        std::array<uint8_t, row_batch::kMaxDigits> digits_buffer{};
+        auto const                                 digits = std::span{digits_buffer}.first(batch.len);
+        for(size_t i = 0; i < batch.size; ++i)
+        {
+            for(size_t k = 0; k < digits.size(); ++k)
+                digits[k] = batch.digits[k][i];
+            out[i] = self().check(batch.numbers[i], digits);
+        }
+    }
+
 protected:
     constexpr auto& self() const noexcept { return static_cast<Derived const&>(*this); }
+
+    static constexpr auto to_number(std::span<uint8_t const> digits) noexcept -> int64_t
+    {
+        return std::ranges::fold_left(digits, int64_t{}, [](auto acc, auto c) { return 10 * acc + c; });
+    }
+
+    constexpr auto run_automaton(std::span<uint8_t const> digits) const noexcept -> automaton_state
+    {
+        auto state = self().initial_state();
+        for(size_t i = 0; i < digits.size() && state != kDeadState; ++i)
+            state = self().next_state(state, digits[i]);
+        return state;
+    }
+
+    // Calls `f(lo, hi)` with the smallest and largest numbers made of `prefix` followed by 1 to `remaining_len` digits
+    // from 1-9, one call per length, until it returns true.
+    template<class F>
+    static constexpr bool any_extension_range(std::span<uint8_t const> prefix, size_t const remaining_len, F&& f)
+    {
+        auto const x     = to_number(prefix);
+        int64_t    scale = 1;
+        int64_t    ones  = 0;
+        for(size_t k = 1; k <= remaining_len; ++k)
+        {
+            scale *= 10;
+            ones = 10 * ones + 1;
+            if(f(x * scale + ones, x * scale + scale - 1))
+                return true;
+        }
+        return false;
+    }
+};
+
+
+// Whether each residue modulo M is a square.
+template<size_t M>
+inline constexpr auto squares_mod = []
+{
+    std::array<bool, M> res{};
+    for(size_t i = 0; i < M; ++i)
+        res[i * i % M] = true;
+    return res;
+}();
+
+// Integer square root and the quadratic residue filters in front of it.
+struct square_root
+{
+    // Largest s with s * s <= x. The floating estimate is off by at most one for 64-bit inputs.
+    static constexpr auto isqrt(int64_t const x) noexcept -> int64_t
+    {
+        auto s = static_cast<int64_t>(std::sqrt(static_cast<double>(x)));
+        s -= s * s > x;
+        s += (s + 1) * (s + 1) <= x;
+        return s;
+    }
+
+    // Squares modulo 64, 63, 65 and 11 let through 12/64, 16/63, 21/65 and 6/11 of the residues, so fewer than 1% of
+    // the numbers reach the square root. The last three share a single division by 63 * 65 * 11.
+    static constexpr bool may_be_square(int64_t const x) noexcept
+    {
+        if(!((kSquaresMod64 >> (x & 63)) & 1))
+            return false;
+
+        auto const r = static_cast<uint32_t>(x % (63 * 65 * 11));
+        return kSquaresMod63[r % 63] && kSquaresMod65[r % 65] && kSquaresMod11[r % 11];
+    }
+
+    static constexpr bool is_square(int64_t const x) noexcept
+    {
+        if(x < 0 || !may_be_square(x))
+            return false;
+
+        auto const s = isqrt(x);
+        return s * s == x;
+    }
+
+private:
+    static constexpr uint64_t kSquaresMod64 = []
+    {
+        uint64_t res = 0;
+        for(uint64_t i = 0; i < 64; ++i)
+            res |= uint64_t{1} << (i * i % 64);
+        return res;
+    }();
+
+    static constexpr auto kSquaresMod63 = squares_mod<63>;
+    static constexpr auto kSquaresMod65 = squares_mod<65>;
+    static constexpr auto kSquaresMod11 = squares_mod<11>;
 };
 
 
 struct is_perfect_square : row_predicate<is_perfect_square>
 {
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return any_extension_range(prefix, remaining_len,
+                                   [](int64_t const lo, int64_t const hi)
+                                   {
+                                       auto const s = square_root::isqrt(lo - 1) + 1;
+                                       return s * s <= hi;
+                                   });
+    }
+
 private:
     friend class row_predicate<is_perfect_square>;
 
     constexpr auto check(int64_t const x, std::span<uint8_t const>) const noexcept -> bool
     {
-        auto const s = static_cast<int64_t>(std::sqrt(x));
-        return s * s == x || (s + 1) * (s + 1) == x;
+        return square_root::is_square(x);
     }
 };
 
 
 struct is_odd_palindrome : row_predicate<is_odd_palindrome>
 {
+    // Some final length must mirror the digits of the prefix that already face each other.
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        if(!(prefix.front() & 1))
+            return false;
+
+        for(size_t len = prefix.size() + 1; len <= prefix.size() + remaining_len; ++len)
+        {
+            bool is_mirrored = true;
+            for(size_t i = len - prefix.size(); i < prefix.size() && is_mirrored; ++i)
+                is_mirrored = prefix[i] == prefix[len - 1 - i];
+
+            if(is_mirrored)
+                return true;
+        }
+        return false;
+    }
+
 private:
     friend class row_predicate<is_odd_palindrome>;
 
@@ -104,98 +276,204 @@ struct fibonacci_sequence
 
 struct is_fibonacci : row_predicate<is_fibonacci>
 {
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return any_extension_range(prefix, remaining_len,
+                                   [](int64_t const lo, int64_t const hi)
+                                   {
+                                       auto const it = std::ranges::lower_bound(fibonacci_seq_, lo);
+                                       return it != fibonacci_seq_.end() && *it <= hi;
+                                   });
+    }
+
 private:
     friend class row_predicate<is_fibonacci>;
 
+    // Precompute Fibonacci sequence array up to 93-th term.
+    // Fibonacci(93) = 12200160415121876738, which is the largest Fibonacci number that fits in int64_t.
+    static constexpr auto fibonacci_seq_ = fibonacci_sequence::compute<93>();
+
     constexpr auto check(int64_t const x, std::span<uint8_t const>) const noexcept -> bool
     {
-        // Precompute Fibonacci sequence array up to 93-th term.
-        // Fibonacci(93) = 12200160415121876738, which is the largest Fibonacci number that fits in int64_t.
-        static constexpr auto fibonacci_seq_ = fibonacci_sequence::compute<93>();
         return std::ranges::binary_search(fibonacci_seq_, x);
     }
 };
 
 
+// Arithmetic modulo an odd n < 2^63 in Montgomery form, x * 2^64 mod n, where a product is reduced with two
+// multiplications and a shift instead of a 128-bit division.
+class montgomery
+{
+public:
+    constexpr explicit montgomery(uint64_t const n) noexcept
+        : n_{n},
+          neg_inv_{neg_inverse_(n)},
+          one_{(0 - n) % n},
+          r2_{static_cast<uint64_t>(static_cast<__uint128_t>(one_) * one_ % n)}
+    {}
+
+    constexpr auto one() const noexcept -> uint64_t { return one_; }
+    constexpr auto minus_one() const noexcept -> uint64_t { return n_ - one_; }
+
+    constexpr auto to_form(uint64_t const x) const noexcept -> uint64_t { return mul(x % n_, r2_); }
+
+    INLINE constexpr auto mul(uint64_t const a, uint64_t const b) const noexcept -> uint64_t
+    {
+        auto const t = static_cast<__uint128_t>(a) * b;
+        auto const m = static_cast<uint64_t>(t) * neg_inv_;
+        auto const r = static_cast<uint64_t>((t + static_cast<__uint128_t>(m) * n_) >> 64);
+        return r >= n_ ? r - n_ : r;
+    }
+
+    constexpr auto pow(uint64_t base, uint64_t exp) const noexcept -> uint64_t
+    {
+        uint64_t res = one_;
+        for(; exp > 0; exp >>= 1)
+        {
+            if(exp & 1)
+                res = mul(res, base);
+            base = mul(base, base);
+        }
+        return res;
+    }
+
+private:
+    // -1/n mod 2^64 by Newton iteration, each step doubling the correct low bits of n * inv = 1.
+    static constexpr auto neg_inverse_(uint64_t const n) noexcept -> uint64_t
+    {
+        uint64_t inv = n;
+        for(int i = 0; i < 5; ++i)
+            inv *= 2 - n * inv;
+        return 0 - inv;
+    }
+
+    uint64_t n_;
+    uint64_t neg_inv_;
+    uint64_t one_;
+    uint64_t r2_;
+};
+
+
 struct is_prime : row_predicate<is_prime>
 {
 private:
     friend class row_predicate<is_prime>;
 
+    // Deterministic Miller-Rabin base sets by bound: 3 bases below 2^32, 4 up to 12 digits, 7 for any 64-bit number.
+    static constexpr std::array<uint64_t, 3> kBases32{2, 7, 61};
+    static constexpr std::array<uint64_t, 4> kBases40{2, 13, 23, 1662803};
+    static constexpr std::array<uint64_t, 7> kBases64{2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+    static constexpr uint64_t kBound32 = 4'759'123'141;
+    static constexpr uint64_t kBound40 = 1'122'004'669'633;
+
     constexpr auto check(int64_t const x, std::span<uint8_t const>) const noexcept -> bool
     {
         if(x < 2)
             return false;
 
-        // Handle small primes directly
-        for(auto const p: {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47})
+        for(auto const p: {2, 3, 5, 7, 11, 13})
         {
-            if(x == p)
-                return true;
-            if(x % p == 0 && x != p)
-                return false;
+            if(x % p == 0)
+                return x == p;
         }
+        if(x < 17 * 17)
+            return true;
 
-        // Deterministic Miller-Rabin bases for 64-bit integers
-        for(auto const b: {2, 325, 9375, 28178, 450775, 9780504, 1795265022})
+        auto const n = static_cast<uint64_t>(x);
+        if(n < kBound32)
+            return miller_rabin_(n, kBases32);
+        if(n < kBound40)
+            return miller_rabin_(n, kBases40);
+        return miller_rabin_(n, kBases64);
+    }
+
+    template<size_t Size>
+    static constexpr auto miller_rabin_(uint64_t const n, std::array<uint64_t, Size> const& bases) noexcept -> bool
+    {
+        montgomery const mont{n};
+
+        auto const r = std::countr_zero(n - 1);
+        auto const d = (n - 1) >> r;
+        for(auto const base: bases)
         {
-            if(b % x == 0)
-                return true;
-            if(!miller_rabin_test(x, b))
+            // A base that is a multiple of n says nothing.
+            auto const a = base % n;
+            if(a == 0)
+                continue;
+
+            auto x = mont.pow(mont.to_form(a), d);
+            if(x == mont.one() || x == mont.minus_one())
+                continue;
+
+            bool is_witness = true;
+            for(int i = 1; i < r && is_witness; ++i)
+            {
+                x          = mont.mul(x, x);
+                is_witness = x != mont.minus_one();
+            }
+            if(is_witness)
                 return false;
         }
         return true;
     }
+};
+
 
-    // Modular multiplication using 128-bit arithmetic to avoid overflow (platform-dependent)
-    INLINE constexpr auto mul_mod(uint64_t x, uint64_t y, uint64_t m) const noexcept -> uint64_t
+template<int64_t N>
+struct is_multiple_of : row_predicate<is_multiple_of<N>>
+{
+    // The state is the residue of the digits so far.
+    constexpr auto initial_state() const noexcept -> automaton_state
+        requires(N < int64_t{kDeadState})
     {
-        return (static_cast<__uint128_t>(x) * y) % m;
+        return 0;
     }
 
-    constexpr auto pow_mod(uint64_t base, uint64_t exp, uint64_t mod) const noexcept -> uint64_t
+    constexpr auto next_state(automaton_state const r, uint8_t const d) const noexcept -> automaton_state
+        requires(N < int64_t{kDeadState})
     {
-        uint64_t result = 1;
-        uint64_t cur    = base % mod;
-        while(exp > 0)
-        {
-            if(exp & 1)
-                result = mul_mod(result, cur, mod);
-            cur = mul_mod(cur, cur, mod);
-            exp >>= 1;
-        }
-        return result;
+        return (10 * uint64_t{r} + d) % N;
     }
 
-    // Miller-Rabin test for a single base
-    constexpr auto miller_rabin_test(uint64_t n, uint64_t a) const noexcept -> bool
+    constexpr auto accepts(automaton_state const r) const noexcept -> bool
+        requires(N < int64_t{kDeadState})
     {
-        if(n % a == 0)
-            return false;
-        uint64_t d = n - 1;
-        int      r = 0;
-        while((d & 1) == 0)
-        {
-            d >>= 1;
-            ++r;
-        }
-        uint64_t x = pow_mod(a, d, n);
-        if(x == 1 || x == n - 1)
-            return true;
-        for(int i = 1; i < r; ++i)
+        return r == 0;
+    }
+
+    // Same windows as `can_extend`, from the residue alone: the smallest number with a suffix of 1-9 digits is
+    // r * scale + ones, and the window holds a multiple when the distance to the next one fits in it.
+    constexpr auto can_extend_from(automaton_state const r, size_t const remaining_len) const noexcept -> bool
+        requires(N < int64_t{kDeadState})
+    {
+        int64_t scale = 1;
+        int64_t ones  = 0;
+        for(size_t k = 1; k <= remaining_len; ++k)
         {
-            x = mul_mod(x, x, n);
-            if(x == n - 1)
+            scale *= 10;
+            ones = 10 * ones + 1;
+
+            auto const lo = (uint64_t{r} * (scale % N) + ones % N) % N;
+            if((N - int64_t(lo)) % N <= scale - 1 - ones)
                 return true;
         }
         return false;
     }
-};
 
+    constexpr void check_batch(row_batch const& batch, row_batch::lane_flags& out) const noexcept
+    {
+        for(size_t i = 0; i < row_batch::kLanes; ++i)
+            out[i] = batch.numbers[i] % N == 0;
+    }
+
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return row_predicate<is_multiple_of<N>>::any_extension_range(
+            prefix, remaining_len,
+            [](int64_t const lo, int64_t const hi) { return (lo + N - 1) / N * N <= hi; });
+    }
 
-template<int64_t N>
-struct is_multiple_of : row_predicate<is_multiple_of<N>>
-{
 private:
     friend class row_predicate<is_multiple_of<N>>;
 
@@ -203,12 +481,54 @@ private:
 };
 
 
-template<int64_t N>
-struct product_of_digits_matches : row_predicate<product_of_digits_matches<N>>
+// Product of digits logic shared by compile-time and run-time targets.
+struct digit_product
 {
-    constexpr auto allowed_digits() const noexcept -> std::bitset<10>
+    // The state holds the exponents of 2, 3, 5 and 7 the remaining digits still have to supply, one byte each.
+    static constexpr auto initial_state(int64_t n) noexcept -> automaton_state
+    {
+        if(n < 1)
+            return kDeadState;
+
+        automaton_state res = 0;
+        for(int shift = 0; auto const p: {2, 3, 5, 7})
+        {
+            automaton_state exponent = 0;
+            for(; n % p == 0; n /= p)
+                ++exponent;
+            if(exponent > 127)
+                return kDeadState;
+            res |= exponent << shift;
+            shift += 8;
+        }
+        return n == 1 ? res : kDeadState;
+    }
+
+    // Subtracts the exponents of `d` from all four bytes at once. With the high bit of every byte set, a byte keeps it
+    // only when it does not run out.
+    static constexpr auto next_state(automaton_state const state, uint8_t const d) noexcept -> automaton_state
     {
-        int64_t m = N;
+        if(d == 0)
+            return kDeadState;
+
+        auto const exponents = kDigitExponents[d];
+        return (((state | 0x80808080u) - exponents) & 0x80808080u) == 0x80808080u ? state - exponents : kDeadState;
+    }
+
+    static constexpr auto accepts(automaton_state const state) noexcept -> bool { return state == 0; }
+
+    // Same count as `can_extend` below: nines and eights first, then one or two digits for what is left of 2 and 3.
+    static constexpr auto can_extend_from(automaton_state const state, size_t const remaining_len) noexcept -> bool
+    {
+        constexpr std::array<std::array<uint8_t, 2>, 3> kLeftoverDigits{{{0, 1}, {1, 1}, {1, 2}}};
+
+        auto const e2 = state & 0xff, e3 = (state >> 8) & 0xff, e5 = (state >> 16) & 0xff, e7 = state >> 24;
+        return e5 + e7 + e3 / 2 + e2 / 3 + kLeftoverDigits[e2 % 3][e3 % 2] <= remaining_len;
+    }
+
+    static constexpr auto allowed_digits(int64_t const n) noexcept -> std::bitset<10>
+    {
+        int64_t m = n;
 
         std::array<int, 10> factor_count{};
         for(auto const f: {2, 3, 5, 7})
@@ -233,23 +553,151 @@ struct product_of_digits_matches : row_predicate<product_of_digits_matches<N>>
         return allowed_digits;
     }
 
+    // The rest of `n` has to split into at most `remaining_len` digits, taking the largest digit factors first.
+    static constexpr auto can_extend(int64_t const n, std::span<uint8_t const> prefix,
+                                     size_t const remaining_len) noexcept -> bool
+    {
+        auto const p = std::ranges::fold_left(prefix, int64_t{1}, std::multiplies{});
+        if(p == 0 || n % p != 0)
+            return false;
+
+        int64_t q          = n / p;
+        size_t  min_digits = 0;
+        for(int64_t d = 9; d > 1; --d)
+        {
+            for(; q % d == 0; q /= d)
+                ++min_digits;
+        }
+        return q == 1 && min_digits <= remaining_len;
+    }
+
+private:
+    static constexpr std::array<automaton_state, 10> kDigitExponents{
+        0, 0, 0x000001, 0x000100, 0x000002, 0x010000, 0x000101, 0x01000000, 0x000003, 0x000200};
+};
+
+
+template<int64_t N>
+struct product_of_digits_matches : row_predicate<product_of_digits_matches<N>>
+{
+    constexpr auto allowed_digits() const noexcept -> std::bitset<10> { return digit_product::allowed_digits(N); }
+
+    constexpr auto initial_state() const noexcept -> automaton_state { return kInitialState; }
+
+    constexpr auto next_state(automaton_state const state, uint8_t const d) const noexcept -> automaton_state
+    {
+        return digit_product::next_state(state, d);
+    }
+
+    constexpr auto accepts(automaton_state const state) const noexcept -> bool { return digit_product::accepts(state); }
+
+    constexpr auto can_extend_from(automaton_state const state, size_t const remaining_len) const noexcept -> bool
+    {
+        return digit_product::can_extend_from(state, remaining_len);
+    }
+
+    constexpr void check_batch(row_batch const& batch, row_batch::lane_flags& out) const noexcept
+    {
+        std::array<int64_t, row_batch::kLanes> product{};
+        product.fill(1);
+        for(size_t k = 0; k < batch.len; ++k)
+            for(size_t i = 0; i < row_batch::kLanes; ++i)
+                product[i] *= batch.digits[k][i];
+
+        for(size_t i = 0; i < row_batch::kLanes; ++i)
+            out[i] = product[i] == N;
+    }
+
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return digit_product::can_extend(N, prefix, remaining_len);
+    }
+
 private:
     friend class row_predicate<product_of_digits_matches<N>>;
 
+    static constexpr automaton_state kInitialState = digit_product::initial_state(N);
+
     constexpr auto check(int64_t const, std::span<uint8_t const> digits) const noexcept -> bool
     {
-        return std::ranges::fold_left(digits, int64_t{1}, std::multiplies{}) == N;
+        return this->run_automaton(digits) == 0;
     }
 };
 
 struct is_divisible_by_its_digits : row_predicate<is_divisible_by_its_digits>
 {
+    // The state holds the number modulo lcm(1, ..., 9) = 2520 in its low 12 bits and the set of its digits above.
+    // Numbers with a 5 and an even digit end with 0, so they go dead right away.
+    constexpr auto initial_state() const noexcept -> automaton_state { return 0; }
+
+    constexpr auto next_state(automaton_state const state, uint8_t const d) const noexcept -> automaton_state
+    {
+        auto const used = (state >> kUsedShift) | (1u << d);
+        if(d == 0 || ((used & kFive) && (used & kEven)))
+            return kDeadState;
+        return ((state & kResidueMask) * 10 + d) % kLcm | (used << kUsedShift);
+    }
+
+    constexpr auto accepts(automaton_state const state) const noexcept -> bool
+    {
+        return ((state >> kUsedShift) & ~divisors_[state & kResidueMask]) == 0;
+    }
+
+    constexpr auto can_extend_from(automaton_state, size_t) const noexcept -> bool { return true; }
+
+    // Divides by digit value rather than by each digit, so the divisions stay by constants.
+    constexpr void check_batch(row_batch const& batch, row_batch::lane_flags& out) const noexcept
+    {
+        std::array<uint16_t, row_batch::kLanes> used{};
+        for(size_t k = 0; k < batch.len; ++k)
+            for(size_t i = 0; i < row_batch::kLanes; ++i)
+                used[i] |= uint16_t{1} << batch.digits[k][i];
+
+        out.fill(true);
+        [&]<int... Ds>(std::integer_sequence<int, Ds...>)
+        {
+            auto const check_digit = [&]<int D>(std::integral_constant<int, D>)
+            {
+                for(size_t i = 0; i < row_batch::kLanes; ++i)
+                    out[i] &= !((used[i] >> D) & 1) || batch.numbers[i] % D == 0;
+            };
+            (check_digit(std::integral_constant<int, Ds + 2>{}), ...);
+        }(std::make_integer_sequence<int, 8>{});
+    }
+
+    // A multiple of both 2 and 5 ends with 0, which is never a digit.
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t) const noexcept -> bool
+    {
+        auto const has_digit = [&](auto pred) { return std::ranges::any_of(prefix, pred); };
+        return !(has_digit([](auto d) { return d == 5; }) && has_digit([](auto d) { return d % 2 == 0; }));
+    }
+
 private:
     friend class row_predicate<is_divisible_by_its_digits>;
 
+    static constexpr automaton_state kLcm         = 2520;
+    static constexpr automaton_state kResidueMask = 0xfff;
+    static constexpr int             kUsedShift   = 12;
+    static constexpr automaton_state kFive        = 1u << 5;
+    static constexpr automaton_state kEven        = (1u << 2) | (1u << 4) | (1u << 6) | (1u << 8);
+
+    // Digits dividing each residue modulo 2520, as bit masks.
+    static constexpr auto divisors_ = []
+    {
+        std::array<uint16_t, kLcm> res{};
+        for(automaton_state r = 0; r < kLcm; ++r)
+            for(automaton_state d = 1; d <= 9; ++d)
+                if(r % d == 0)
+                    res[r] |= uint16_t(1u << d);
+        return res;
+    }();
+
+    // One division, then a table lookup, in place of one division per digit.
     constexpr auto check(int64_t const x, std::span<uint8_t const> digits) const noexcept -> bool
     {
-        return std::ranges::all_of(digits, [&](auto d) { return x % d == 0; });
+        auto const used =
+            std::ranges::fold_left(digits, automaton_state{}, [](auto acc, auto d) { return acc | (1u << d); });
+        return (used & ~automaton_state{divisors_[x % kLcm]}) == 0;
     }
 };
 
@@ -0,0 +1,418 @@
+#include "2025/may/number_cross_grid_predicates.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+
+// Digits of `x`, most significant first.
+std::vector<uint8_t> digits_of(int64_t x)
+{
+    std::vector<uint8_t> res;
+    for(; x > 0; x /= 10)
+        res.push_back(static_cast<uint8_t>(x % 10));
+    std::ranges::reverse(res);
+    return res;
+}
+
+// Random numbers of 2 to `max_len` digits made of the ones `pred` allows, as the candidate tables enumerate them,
+// followed by those of `extra` whose digits it allows.
+template<class Pred>
+std::vector<int64_t> make_numbers(Pred const& pred, size_t const max_len, std::vector<int64_t> const& extra)
+{
+    std::vector<uint8_t> allowed;
+    for(uint8_t d = 1; d < 10; ++d)
+        if(pred.allowed_digits().test(d))
+            allowed.push_back(d);
+
+    std::mt19937_64                       rng{2025};
+    std::uniform_int_distribution<size_t> pick{0, allowed.size() - 1};
+
+    std::vector<int64_t> res;
+    for(size_t len = 2; len <= max_len; ++len)
+    {
+        for(int i = 0; i < 200; ++i)
+        {
+            int64_t x = 0;
+            for(size_t k = 0; k < len; ++k)
+                x = 10 * x + allowed[pick(rng)];
+            res.push_back(x);
+        }
+    }
+
+    for(auto const x: extra)
+    {
+        auto const digits = digits_of(x);
+        if(digits.size() >= 2 && std::ranges::all_of(digits, [&](auto d) { return pred.allowed_digits().test(d); }))
+            res.push_back(x);
+    }
+    return res;
+}
+
+// Packs `numbers` into batches of equal length, leaving garbage in the unused lanes of the last batch of each length.
+std::vector<row_batch> make_batches(std::vector<int64_t> const& numbers)
+{
+    std::map<size_t, std::vector<int64_t>> by_len;
+    for(auto const x: numbers)
+        by_len[digits_of(x).size()].push_back(x);
+
+    std::vector<row_batch> res;
+    for(auto const& [len, xs]: by_len)
+    {
+        for(size_t first = 0; first < xs.size(); first += row_batch::kLanes)
+        {
+            row_batch batch{.len = len};
+            batch.numbers.fill(987654321);
+            for(; batch.size < row_batch::kLanes && first + batch.size < xs.size(); ++batch.size)
+            {
+                auto const x      = xs[first + batch.size];
+                auto const digits = digits_of(x);
+                for(size_t k = 0; k < len; ++k)
+                    batch.digits[k][batch.size] = digits[k];
+                batch.numbers[batch.size] = x;
+            }
+            res.push_back(batch);
+        }
+    }
+    return res;
+}
+
+// Checks `pred` on every number lane by lane, one by one, and with the brute-force `expected`.
+template<class Pred, class Expected>
+void expect_predicate(Pred const& pred, std::vector<int64_t> const& numbers, Expected&& expected)
+{
+    size_t accepted = 0;
+    for(auto const& batch: make_batches(numbers))
+    {
+        row_batch::lane_flags out{};
+        pred.check_batch(batch, out);
+
+        for(size_t i = 0; i < batch.size; ++i)
+        {
+            auto const x                  = batch.numbers[i];
+            auto const digits             = digits_of(x);
+            auto const [is_valid, number] = pred(digits);
+
+            ASSERT_EQ(number, x);
+            ASSERT_EQ(is_valid, expected(x)) << x;
+            ASSERT_EQ(out[i], is_valid) << x;
+            accepted += is_valid;
+        }
+    }
+
+    // The extra numbers make sure both answers are exercised.
+    EXPECT_GT(accepted, 0);
+    EXPECT_LT(accepted, numbers.size());
+}
+
+bool is_square_brute(int64_t const x)
+{
+    int64_t lo = 0, hi = 3'037'000'499;
+    while(lo < hi)
+    {
+        auto const mid = lo + (hi - lo + 1) / 2;
+        if(mid * mid <= x)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo * lo == x;
+}
+
+bool is_prime_brute(int64_t const x)
+{
+    if(x < 2)
+        return false;
+    for(int64_t p = 2; p * p <= x; ++p)
+        if(x % p == 0)
+            return false;
+    return true;
+}
+
+int64_t digit_product_of(int64_t const x)
+{
+    return std::ranges::fold_left(digits_of(x), int64_t{1}, std::multiplies{});
+}
+
+// Walks every number of up to `max_len` digits from 1-9 starting with `digits`, feeding each digit to the automaton of
+// `pred` from `state`. Checks that the automaton accepts exactly the valid numbers, and that `can_extend_from` never
+// rules out a prefix that still has a valid extension. With `is_prefix_exact`, it also has to agree with `can_extend`.
+// Returns whether some valid number extends `digits` by exactly k digits, for each k.
+template<class Pred>
+std::vector<bool> expect_automaton_from(Pred const& pred, std::vector<uint8_t>& digits, automaton_state const state,
+                                        size_t const max_len, bool const is_prefix_exact)
+{
+    std::vector<bool> is_valid_after(max_len - digits.size() + 1);
+    if(digits.size() >= 2)
+    {
+        auto const [is_valid, x] = pred(digits);
+        EXPECT_EQ(state != kDeadState && pred.accepts(state), is_valid) << x;
+        is_valid_after[0] = is_valid;
+    }
+
+    for(uint8_t d = 1; d < 10 && digits.size() < max_len; ++d)
+    {
+        digits.push_back(d);
+        auto const next           = (state == kDeadState) ? kDeadState : pred.next_state(state, d);
+        auto const is_valid_below = expect_automaton_from(pred, digits, next, max_len, is_prefix_exact);
+        digits.pop_back();
+
+        for(size_t k = 0; k < is_valid_below.size(); ++k)
+            is_valid_after[k + 1] = is_valid_after[k + 1] || is_valid_below[k];
+    }
+
+    if(state == kDeadState)
+    {
+        EXPECT_TRUE(std::ranges::none_of(is_valid_after, std::identity{})) << "dead state after " << digits.size();
+        return is_valid_after;
+    }
+
+    if(digits.empty())
+        return is_valid_after;
+
+    bool can_reach = false;
+    for(size_t remaining_len = 1; remaining_len < is_valid_after.size(); ++remaining_len)
+    {
+        can_reach = can_reach || is_valid_after[remaining_len];
+
+        auto const can_extend = pred.can_extend_from(state, remaining_len);
+        if(can_reach)
+            EXPECT_TRUE(can_extend) << "prefix of " << digits.size() << " digits, " << remaining_len << " more";
+        if(is_prefix_exact)
+            EXPECT_EQ(can_extend, pred.can_extend(digits, remaining_len))
+                << "prefix of " << digits.size() << " digits, " << remaining_len << " more";
+    }
+    return is_valid_after;
+}
+
+template<class Pred>
+void expect_automaton(Pred const& pred, size_t const max_len, bool const is_prefix_exact)
+{
+    std::vector<uint8_t> digits;
+    expect_automaton_from(pred, digits, pred.initial_state(), max_len, is_prefix_exact);
+}
+
+// Runs `pred` on `x` alone, for predicates that only look at the number.
+template<class Pred>
+bool check_number(Pred const& pred, int64_t const x)
+{
+    row_batch batch{.size = 1};
+    batch.numbers[0] = x;
+
+    row_batch::lane_flags out{};
+    pred.check_batch(batch, out);
+    return out[0];
+}
+
+} // namespace
+
+
+TEST(NumberCrossPredicatesTest, PerfectSquare)
+{
+    std::vector<int64_t> squares;
+    for(int64_t s: {11, 34, 315, 1'111, 31'622, 99'999, 316'227, 3'162'277, 31'622'776, 99'999'999})
+        for(int64_t k = s - 40; k <= s + 40; ++k)
+            squares.insert(squares.end(), {k * k - 1, k * k, k * k + 1});
+
+    expect_predicate(is_perfect_square{}, make_numbers(is_perfect_square{}, 16, squares), is_square_brute);
+}
+
+TEST(NumberCrossPredicatesTest, OddPalindrome)
+{
+    std::vector<int64_t> palindromes{11, 12, 121, 242, 12321, 123454321, 1357997531, 987656789, 135797531};
+
+    expect_predicate(is_odd_palindrome{}, make_numbers(is_odd_palindrome{}, 12, palindromes),
+                     [](int64_t const x)
+                     {
+                         auto const s = std::to_string(x);
+                         return x % 2 == 1 && std::ranges::equal(s, s | std::views::reverse);
+                     });
+}
+
+TEST(NumberCrossPredicatesTest, Fibonacci)
+{
+    std::vector<int64_t> fibonacci{0, 1};
+    while(fibonacci.back() < 1'000'000'000'000'000)
+        fibonacci.push_back(fibonacci[fibonacci.size() - 1] + fibonacci[fibonacci.size() - 2]);
+
+    expect_predicate(is_fibonacci{}, make_numbers(is_fibonacci{}, 18, fibonacci),
+                     [&](int64_t const x) { return std::ranges::find(fibonacci, x) != fibonacci.end(); });
+}
+
+TEST(NumberCrossPredicatesTest, Prime)
+{
+    std::vector<int64_t> primes;
+    for(int64_t x = 10; x < 20'000; ++x)
+        if(is_prime_brute(x))
+            primes.push_back(x);
+
+    expect_predicate(is_prime{}, make_numbers(is_prime{}, 9, primes), is_prime_brute);
+}
+
+TEST(NumberCrossPredicatesTest, MultipleOf)
+{
+    std::vector<int64_t> multiples;
+    for(int64_t k = 1; k < 2'000; ++k)
+        multiples.insert(multiples.end(), {13 * k, 2025 * k * 7919});
+
+    expect_predicate(is_multiple_of<13>{}, make_numbers(is_multiple_of<13>{}, 18, multiples),
+                     [](int64_t const x) { return x % 13 == 0; });
+    expect_predicate(is_multiple_of<2025>{}, make_numbers(is_multiple_of<2025>{}, 18, multiples),
+                     [](int64_t const x) { return x % 2025 == 0; });
+}
+
+TEST(NumberCrossPredicatesTest, ProductOfDigits)
+{
+    std::vector<int64_t> matches{45, 54, 225, 522, 4511, 225111111111111, 5599, 9955, 3355119, 959511, 1111111155991};
+
+    expect_predicate(product_of_digits_matches<20>{}, make_numbers(product_of_digits_matches<20>{}, 18, matches),
+                     [](int64_t const x) { return digit_product_of(x) == 20; });
+    expect_predicate(product_of_digits_matches<2025>{}, make_numbers(product_of_digits_matches<2025>{}, 18, matches),
+                     [](int64_t const x) { return digit_product_of(x) == 2025; });
+}
+
+TEST(NumberCrossPredicatesTest, DivisibleByItsDigits)
+{
+    std::vector<int64_t> divisible;
+    for(int64_t x = 11; x < 100'000; ++x)
+    {
+        auto const digits = digits_of(x);
+        if(std::ranges::all_of(digits, [&](auto d) { return d != 0 && x % d == 0; }))
+            divisible.push_back(x);
+    }
+
+    expect_predicate(is_divisible_by_its_digits{}, make_numbers(is_divisible_by_its_digits{}, 18, divisible),
+                     [](int64_t const x)
+                     { return std::ranges::all_of(digits_of(x), [&](auto d) { return x % d == 0; }); });
+}
+
+TEST(NumberCrossPredicatesTest, MultipleOfAutomaton)
+{
+    expect_automaton(is_multiple_of<13>{}, 6, true);
+    expect_automaton(is_multiple_of<32>{}, 6, true);
+    expect_automaton(is_multiple_of<2025>{}, 6, true);
+}
+
+TEST(NumberCrossPredicatesTest, ProductOfDigitsAutomaton)
+{
+    expect_automaton(product_of_digits_matches<20>{}, 6, true);
+    expect_automaton(product_of_digits_matches<25>{}, 6, true);
+    expect_automaton(product_of_digits_matches<2025>{}, 6, true);
+    expect_automaton(product_of_digits_matches<5040>{}, 6, true);
+}
+
+TEST(NumberCrossPredicatesTest, ProductOfDigitsInitialState)
+{
+    // Exponents of 2, 3, 5 and 7 take one byte each, and any other prime factor leaves no way to reach the product.
+    EXPECT_EQ(digit_product::initial_state(2025), 0x00020400u);
+    EXPECT_EQ(digit_product::initial_state(int64_t{1} << 40), 40u);
+    EXPECT_EQ(digit_product::initial_state(11), kDeadState);
+    EXPECT_EQ(digit_product::initial_state(0), kDeadState);
+}
+
+TEST(NumberCrossPredicatesTest, DivisibleByItsDigitsAutomaton)
+{
+    expect_automaton(is_divisible_by_its_digits{}, 6, false);
+}
+
+TEST(NumberCrossPredicatesTest, IntegerSquareRoot)
+{
+    for(int64_t x = 0; x < 1'000'000; ++x)
+    {
+        auto const s = square_root::isqrt(x);
+        ASSERT_TRUE(s * s <= x && (s + 1) * (s + 1) > x) << x;
+        ASSERT_EQ(square_root::is_square(x), s * s == x) << x;
+    }
+
+    // Rows hold at most 18 digits. Near 10^18 the floating estimate can be off by one in either direction.
+    for(int64_t k = 999'999'000; k <= 1'000'000'000; ++k)
+    {
+        for(auto const x: {k * k - 1, k * k, k * k + 1})
+        {
+            ASSERT_EQ(square_root::isqrt(x), x < k * k ? k - 1 : k) << x;
+            ASSERT_EQ(square_root::is_square(x), x == k * k) << x;
+        }
+    }
+}
+
+TEST(NumberCrossPredicatesTest, SquareResidueFilter)
+{
+    size_t passed = 0;
+    for(int64_t x = 0; x < 1'000'000; ++x)
+        passed += square_root::may_be_square(x);
+    for(int64_t k = 0; k < 1'000'000; ++k)
+        ASSERT_TRUE(square_root::may_be_square(k * k)) << k;
+
+    EXPECT_LT(passed, 10'000);
+}
+
+TEST(NumberCrossPredicatesTest, MontgomeryArithmetic)
+{
+    std::mt19937_64 rng{2025};
+    for(uint64_t n: {uint64_t{3}, uint64_t{1'000'000'007}, uint64_t{4'759'123'141}, (uint64_t{1} << 61) - 1,
+                     (uint64_t{1} << 63) - 25})
+    {
+        montgomery const mont{n};
+        auto const       from_form = [&](uint64_t const x) { return mont.mul(x, 1); };
+
+        EXPECT_EQ(from_form(mont.one()), 1 % n);
+        EXPECT_EQ(from_form(mont.minus_one()), n - 1);
+        for(int i = 0; i < 1000; ++i)
+        {
+            auto const a = rng() % n, b = rng() % n, e = rng() % 1000;
+
+            auto const product = static_cast<uint64_t>(static_cast<__uint128_t>(a) * b % n);
+            ASSERT_EQ(from_form(mont.mul(mont.to_form(a), mont.to_form(b))), product) << a << " * " << b << " % " << n;
+
+            uint64_t power = 1 % n;
+            for(uint64_t j = 0; j < e; ++j)
+                power = static_cast<uint64_t>(static_cast<__uint128_t>(power) * a % n);
+            ASSERT_EQ(from_form(mont.pow(mont.to_form(a), e)), power) << a << " ^ " << e << " % " << n;
+        }
+    }
+}
+
+TEST(NumberCrossPredicatesTest, MillerRabinMatchesSieve)
+{
+    constexpr int64_t kLimit = 2'000'000;
+    std::vector<bool> is_composite(kLimit);
+    for(int64_t p = 2; p * p < kLimit; ++p)
+        if(!is_composite[p])
+            for(int64_t q = p * p; q < kLimit; q += p)
+                is_composite[q] = true;
+
+    for(int64_t x = 0; x < kLimit; ++x)
+        ASSERT_EQ(check_number(is_prime{}, x), x >= 2 && !is_composite[x]) << x;
+}
+
+TEST(NumberCrossPredicatesTest, MillerRabinAroundBaseBounds)
+{
+    // Numbers on both sides of the switches between base sets, where a wrong bound lets a strong pseudoprime through.
+    for(int64_t const bound: {int64_t{4'759'123'141}, int64_t{1'122'004'669'633}})
+        for(int64_t x = bound - 100; x <= bound + 100; ++x)
+            ASSERT_EQ(check_number(is_prime{}, x), is_prime_brute(x)) << x;
+}
+
+TEST(NumberCrossPredicatesTest, MillerRabinKnownNumbers)
+{
+    // Strong pseudoprimes to small base sets, Carmichael numbers, and products of large primes.
+    for(int64_t const x: {int64_t{3'215'031'751}, int64_t{4'759'123'141}, int64_t{1'122'004'669'633},
+                          int64_t{3'825'123'056'546'413'051}, int64_t{561}, int64_t{41'041}, int64_t{825'265},
+                          int64_t{999'999'999'989} * 11, int64_t{999'983} * 999'983})
+        EXPECT_FALSE(check_number(is_prime{}, x)) << x;
+
+    for(int64_t const x: {int64_t{4'294'967'291}, int64_t{9'999'999'967}, int64_t{999'999'999'989},
+                          int64_t{999'999'999'999'999'989}, (int64_t{1} << 61) - 1})
+        EXPECT_TRUE(check_number(is_prime{}, x)) << x;
+}
@@ -3,18 +3,38 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <optional>
+#include <stdexcept>
+#include <set>
 #include <ranges>
 #include <span>
 #include <tuple>
-#include <unordered_set>
+#include <vector>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
 
 #include "2025/may/number_cross_cell_partitions.h"
+#include "2025/may/number_cross_checkpoint.h"
+#include "2025/may/number_cross_dead_ends.h"
 #include "2025/may/number_cross_grid.h"
+#include "2025/may/number_cross_number_set.h"
+#include "2025/may/number_cross_row_candidates.h"
+#include "2025/may/number_cross_stats.h"
 #include "spdlog/spdlog.h"
-#include "utils/restorer.h"
 
 
 template<CRowPredicate... Predicates>
@@ -23,19 +43,25 @@ class number_cross_grid_solver
 public:
     static constexpr size_t N = sizeof...(Predicates);
     using grid_type           = number_cross_grid<Predicates...>;
+    using stats_type          = number_cross_stats<N>;
 
     constexpr explicit number_cross_grid_solver(grid_type& grid) noexcept
         : grid_{grid},
           unique_numbers_{}
-    {
-        unique_numbers_.reserve(N * N);
-    }
+    {}
 
     constexpr bool solve()
     {
         SPDLOG_INFO("Started solving grid with N={}", N);
+        stats_.started();
+        init_candidates_();
+        init_region_propagation_();
 
-        if(try_region_configuration_())
+        bool const solved = try_region_configuration_();
+        SPDLOG_INFO("Dead-end table: {} states, {} hits, {} evictions", own_dead_ends_.size(), own_dead_ends_.hits(),
+                    own_dead_ends_.evictions());
+
+        if(solved)
         {
             SPDLOG_INFO("Found solution for grid with N={}:\n{}", N, grid_);
             return true;
@@ -45,6 +71,139 @@ public:
         return false;
     }
 
+    // Hands each region configuration to a worker owning its own grid copy, so tile searches run concurrently. The
+    // earliest configuration with a solution wins, which matches the result of `solve`.
+    bool solve_parallel(int const max_concurrency = tbb::task_arena::automatic)
+    {
+        SPDLOG_INFO("Started solving grid with N={} in parallel", N);
+        stats_.started();
+        init_candidates_();
+        init_region_propagation_();
+
+        struct region_task
+        {
+            size_t                   idx{};
+            std::vector<uint8_t>     region_digits{};
+            std::optional<grid_type> grid{};
+            unique_numbers_type      unique_numbers{};
+            stats_type               stats{};
+        };
+
+        tbb::task_arena arena(max_concurrency);
+        auto const      max_tokens = kTasksPerThread * static_cast<size_t>(arena.max_concurrency());
+
+        std::atomic<size_t>        best_task{kNoTask};
+        std::optional<region_task> solution;
+
+        // One table per thread, so dead-ends found for a configuration still help the next ones on the same thread.
+        tbb::enumerable_thread_specific<dead_ends_type> dead_ends(dead_end_budget_ / arena.max_concurrency());
+
+        size_t task_count    = 0;
+        auto   region_digits = first_region_digits_();
+
+        auto const next_task = [&](tbb::flow_control& fc) -> region_task
+        {
+            stats_.report_progress([&] { return region_progress_(region_digits); });
+            if(best_task.load(std::memory_order_relaxed) == kNoTask && next_region_configuration_(region_digits))
+                return {task_count++, region_digits};
+            fc.stop();
+            return {};
+        };
+
+        auto const run_task = [&](region_task task) -> region_task
+        {
+            if(best_task.load(std::memory_order_relaxed) < task.idx)
+                return task;
+
+            grid_type                grid = grid_;
+            number_cross_grid_solver worker(grid);
+            worker.candidates_ = candidates_;
+            worker.best_task_  = &best_task;
+            worker.task_idx_   = task.idx;
+            worker.dead_ends_  = &dead_ends.local();
+
+            worker.set_region_digits_(task.region_digits);
+            SPDLOG_INFO("Trying region configuration: {}", task.region_digits);
+
+            auto const started = worker.stats_.region_started();
+            bool const solved  = worker.try_grid_configuration_();
+            worker.stats_.region_finished(started);
+
+            task.stats = worker.stats_;
+            if(!solved)
+                return task;
+
+            auto current = best_task.load();
+            while(task.idx < current && !best_task.compare_exchange_weak(current, task.idx))
+            {}
+
+            task.unique_numbers = std::move(worker.unique_numbers_);
+            task.grid           = std::move(grid);
+            return task;
+        };
+
+        // Tasks arrive in order, so every configuration up to an unsolved one has been searched.
+        auto const collect_task = [&](region_task task)
+        {
+            stats_.merge(task.stats);
+            if(solution)
+                return;
+            if(task.grid)
+                solution = std::move(task);
+            else
+                save_checkpoint_(task.region_digits);
+        };
+
+        auto const filters =
+            tbb::make_filter<void, region_task>(tbb::filter_mode::serial_in_order, next_task) &
+            tbb::make_filter<region_task, region_task>(tbb::filter_mode::parallel, run_task) &
+            tbb::make_filter<region_task, void>(tbb::filter_mode::serial_in_order, collect_task);
+
+        arena.execute([&] { tbb::parallel_pipeline(max_tokens, filters); });
+
+        SPDLOG_INFO("Searched {} region configurations", task_count);
+        remove_checkpoint_();
+
+        if(!solution)
+        {
+            SPDLOG_INFO("No solution found for grid with N={}", N);
+            return false;
+        }
+
+        grid_           = std::move(*solution->grid);
+        unique_numbers_ = std::move(solution->unique_numbers);
+
+        SPDLOG_INFO("Found solution for grid with N={}, region_digits={}:\n{}", N, solution->region_digits, grid_);
+        return true;
+    }
+
+    // Calls `on_solution(grid, unique_numbers)` for every solution as soon as it is found, in the order of `solve`,
+    // until it returns false or `max_solutions` were found. Returns how many were found: asking for 2 and getting 1
+    // proves the solution unique. The grid is only valid during the call. After `resume_after`, the grids the
+    // checkpoint reports count as found and are not reported again.
+    template<class F>
+    size_t solve_all(F&& on_solution, size_t const max_solutions = std::numeric_limits<size_t>::max())
+    {
+        SPDLOG_INFO("Started enumerating solutions of grid with N={}, up to {}", N, max_solutions);
+        stats_.started();
+        init_candidates_();
+        init_region_propagation_();
+
+        on_solution_   = std::forward<F>(on_solution);
+        max_solutions_ = max_solutions;
+        reported_      = resume_reported_;
+        solutions_     = reported_.size();
+        if(solutions_ > 0)
+            SPDLOG_INFO("Resuming with {} solutions found before the checkpoint", solutions_);
+
+        bool const stopped = solutions_ >= max_solutions_ || try_region_configuration_();
+        on_solution_       = nullptr;
+        reported_.clear();
+
+        SPDLOG_INFO("Found {} solutions for grid with N={}{}", solutions_, N, stopped ? ", stopped early" : "");
+        return solutions_;
+    }
+
     constexpr bool solve_with_region_digits(std::span<uint8_t const> region_digits)
     {
         auto const grid_regions_sz  = grid_.regions().size();
@@ -70,12 +229,11 @@ public:
                 SPDLOG_ERROR("Digit {} is not allowed for region {}", reg_digit, idx);
                 return false;
             }
-
-            region.set_digit(reg_digit);
-            for(auto [r, c]: region.cells())
-                grid_(r, c) = reg_digit;
         }
 
+        init_candidates_();
+        set_region_digits_(region_digits);
+
         if(try_grid_configuration_())
         {
             SPDLOG_INFO("Found solution for grid with N={}, region_digits={}:\n{}", N, region_digits, grid_);
@@ -86,99 +244,582 @@ public:
         return false;
     }
 
-    constexpr std::unordered_set<int64_t> const& get_unique_numbers() const noexcept { return unique_numbers_; }
+    // Saves the last region configuration searched without a solution to `path`, at most once per `interval`. The file
+    // is removed once the search ends.
+    void set_checkpoint(std::filesystem::path path, std::chrono::seconds const interval)
+    {
+        checkpoint_path_     = std::move(path);
+        checkpoint_interval_ = interval;
+        last_checkpoint_     = checkpoint_clock::now();
+    }
+
+    // Starts the region search right after the configuration of `checkpoint`. A checkpoint reporting grids was saved
+    // by `solve_all`, and only resuming `solve_all` keeps them. Throws std::invalid_argument when the checkpoint is
+    // of another puzzle or its configuration is not one the region search could have reached.
+    void resume_after(number_cross_checkpoint const& checkpoint)
+    {
+        auto const regions_sz = grid_.regions().size();
+        if(checkpoint.grid_size != N || checkpoint.region_digits.size() != regions_sz)
+            throw std::invalid_argument{
+                fmt::format("checkpoint of a {0}x{0} grid with {1} regions, expected {2}x{2} with {3}",
+                            checkpoint.grid_size, checkpoint.region_digits.size(), N, regions_sz)};
+
+        if(checkpoint.fingerprint != grid_.fingerprint())
+            throw std::invalid_argument{fmt::format("checkpoint of another puzzle, fingerprint {:x} instead of {:x}",
+                                                    checkpoint.fingerprint, grid_.fingerprint())};
+
+        init_region_propagation_();
+        for(auto&& [idx, region]: std::views::zip(std::views::iota(0), grid_.regions()))
+        {
+            auto const digit = checkpoint.region_digits[idx];
+            if(!region.get_allowed_digits()[digit])
+                throw std::invalid_argument{fmt::format("digit {} is not allowed for region {}", digit, idx)};
+
+            auto const is_neighbor_digit = [&](auto neighbor_idx)
+            { return checkpoint.region_digits[neighbor_idx] == digit; };
+            if(std::ranges::any_of(region.neighbors(), is_neighbor_digit))
+                throw std::invalid_argument{fmt::format("digit {} of region {} is also a neighbor's", digit, idx)};
+        }
+
+        SPDLOG_INFO("Resuming after region configuration {} with {} reported grids", checkpoint.region_digits,
+                    checkpoint.reported.size());
+        resume_digits_ = checkpoint.region_digits;
+        resume_reported_.clear();
+        for(auto const& rows: checkpoint.reported)
+        {
+            std::array<uint64_t, N> digits{};
+            std::ranges::copy(rows, digits.begin());
+            resume_reported_.insert(digits);
+        }
+    }
+
+    constexpr auto const& get_unique_numbers() const noexcept { return unique_numbers_; }
+    constexpr auto const& get_stats() const noexcept { return stats_; }
+    constexpr auto const& get_dead_ends() const noexcept { return own_dead_ends_; }
+
+    // Memory for remembering row searches without completion, split between the threads of `solve_parallel`. 0
+    // turns it off.
+    void set_dead_end_budget(size_t const bytes)
+    {
+        dead_end_budget_ = bytes;
+        own_dead_ends_.set_budget(bytes);
+    }
 
 private:
-    grid_type&                  grid_;
-    std::unordered_set<int64_t> unique_numbers_{};
+    // Numbers separated by tiles take at least three cells, the last one at least two.
+    static constexpr size_t kMaxRowNumbers = (N + 1) / 3;
 
-    constexpr bool try_region_configuration_(int const region_idx = 0)
+    using unique_numbers_type = flat_number_set<N * kMaxRowNumbers>;
+    using candidates_type     = std::array<row_candidates, N>;
+    using cell_mask           = std::bitset<N * N>;
+
+    // Per digit of a region: the cells it would have to tile, and the cells where no other tile may then go.
+    struct region_tiles
     {
-        if(region_idx >= grid_.regions().size())
+        std::array<cell_mask, 10> forced{};
+        std::array<cell_mask, 10> zone{};
+    };
+
+    static constexpr size_t kNoTask         = std::numeric_limits<size_t>::max();
+    static constexpr size_t kTasksPerThread = 4;
+
+    using checkpoint_clock = std::chrono::steady_clock;
+
+    using row_state = typename grid_type::row_state;
+
+    // Row, the row above and the digits of the rows below, which is all a row search depends on besides the numbers
+    // placed so far.
+    using dead_ends_type = dead_end_table<N + 1>;
+
+    static constexpr size_t kDefaultDeadEndBudget = size_t{64} << 20;
+
+    // Row saved before placing a tile, restored when the search backtracks past it.
+    struct trail_entry
+    {
+        int       row;
+        row_state state;
+    };
+
+    // Digits of a number, unpacked from its row.
+    struct number_digits
+    {
+        std::array<uint8_t, N> buffer{};
+        size_t                 size{0};
+
+        constexpr std::span<uint8_t const> digits() const noexcept { return {buffer.data(), size}; }
+    };
+
+    template<size_t Row>
+    using predicate_type_ = std::remove_cvref_t<decltype(std::declval<grid_type const&>().template predicate<Row>())>;
+
+    // Rows whose numbers are validated digit by digit as the search moves along, instead of when they close.
+    template<size_t Row>
+    static constexpr bool kRunsAutomaton = CAutomatonRowPredicate<predicate_type_<Row>>;
+
+    // Number of a row running up to some column, with the automaton state its digits reached.
+    struct running_number
+    {
+        int64_t         value{0};
+        automaton_state state{kDeadState};
+        uint8_t         len{0};
+    };
+
+    grid_type&          grid_;
+    unique_numbers_type unique_numbers_{};
+
+    // Valid numbers of each row, shared with the parallel workers.
+    std::shared_ptr<candidates_type const> candidates_{};
+
+    std::vector<region_tiles> region_tiles_{};
+    std::vector<int>          region_order_{};
+
+    // Undo log of the rows changed by the tiles placed so far.
+    std::vector<trail_entry> trail_{};
+
+    // running_[Row][col]: the number of `Row` made of its final digits before `col`, for automaton rows.
+    std::array<std::array<running_number, N + 1>, N> running_{};
+
+    stats_type stats_{};
+
+    size_t         dead_end_budget_{kDefaultDeadEndBudget};
+    dead_ends_type own_dead_ends_{kDefaultDeadEndBudget};
+    dead_ends_type* dead_ends_{&own_dead_ends_};
+
+    std::filesystem::path             checkpoint_path_{};
+    std::chrono::seconds              checkpoint_interval_{0};
+    checkpoint_clock::time_point      last_checkpoint_{};
+    std::vector<uint8_t>              resume_digits_{};
+    std::set<std::array<uint64_t, N>> resume_reported_{};
+
+    // Uniqueness collisions so far: a failed search without any does not depend on the numbers of the rows above.
+    size_t collisions_{0};
+
+    // Set by `solve_all`: completed grids are reported and the search goes on until the callback or the limit stops.
+    std::function<bool(grid_type const&, unique_numbers_type const&)> on_solution_{};
+
+    size_t max_solutions_{0};
+    size_t solutions_{0};
+    size_t completions_{0};
+
+    // Digits of the grids reported so far. Diagonal tiles can trade digits through the two cells they both reach, so
+    // different placements may end in the same grid, which is reported once. Tiles are the cells left at 0.
+    std::set<std::array<uint64_t, N>> reported_{};
+
+    // Set on parallel workers: the search gives up once an earlier region configuration has been solved.
+    std::atomic<size_t> const* best_task_{nullptr};
+    size_t                     task_idx_{0};
+
+    constexpr bool is_cancelled_() const noexcept
+    {
+        return best_task_ != nullptr && best_task_->load(std::memory_order_relaxed) < task_idx_;
+    }
+
+    void init_candidates_()
+    {
+        if(candidates_)
+            return;
+
+        auto candidates = std::make_shared<candidates_type>();
+        [&]<size_t... Rows>(std::index_sequence<Rows...>)
+        {
+            ((std::get<Rows>(*candidates) = row_candidates::build(grid_.template predicate<Rows>(), N)), ...);
+        }(std::make_index_sequence<N>{});
+
+        for(size_t row = 0; row < N; ++row)
+            for(size_t len = 2; len <= N; ++len)
+                if((*candidates)[row].is_indexed(len))
+                    SPDLOG_INFO("Row {}: {} valid numbers of length {}", row, (*candidates)[row].size(len), len);
+
+        candidates_ = std::move(candidates);
+    }
+
+    static constexpr int max_digit_(std::bitset<10> const digits) noexcept
+    {
+        int d = 9;
+        while(d > 0 && !digits.test(d))
+            --d;
+        return d;
+    }
+
+    // Narrows the region domains and orders regions most constrained first. Highlighted cells keep the region digit,
+    // so it has to be allowed in each of their rows. Displacements only ever increase digits, so a cell whose row
+    // allows no digit that large has to be tiled: digits forcing tiles that cannot be placed are dropped.
+    void init_region_propagation_()
+    {
+        if(!region_order_.empty())
+            return;
+
+        auto& regions = grid_.regions();
+        region_tiles_.assign(regions.size(), {});
+
+        for(int idx = 0; idx < regions.size(); ++idx)
+        {
+            auto& region = regions[idx];
+
+            std::bitset<10> domain = region.get_allowed_digits();
+            for(auto [r, c]: region.cells())
+                if(grid_.highlighted(r, c))
+                    domain &= grid_.allowed_digits(r);
+
+            for(int d = 1; d < 10; ++d)
+                if(domain.test(d) && !init_forced_tiles_(idx, d))
+                    domain.reset(d);
+
+            SPDLOG_INFO("Region {}: allowed digits narrowed from {} to {}", idx, region.get_allowed_digits().to_string(),
+                        domain.to_string());
+            region.set_allowed_digits(domain);
+        }
+
+        region_order_.resize(regions.size());
+        std::iota(region_order_.begin(), region_order_.end(), 0);
+        std::ranges::stable_sort(region_order_,
+                                 [&](int const a, int const b)
+                                 {
+                                     auto const a_digits = regions[a].get_allowed_digits().count();
+                                     auto const b_digits = regions[b].get_allowed_digits().count();
+                                     if(a_digits != b_digits)
+                                         return a_digits < b_digits;
+                                     return regions[a].neighbors().size() > regions[b].neighbors().size();
+                                 });
+
+        SPDLOG_INFO("Region search order: {}", region_order_);
+    }
+
+    // Records the tiles region `idx` forces with digit `d`. Fails when two of them are too close, when one sits where
+    // it would leave a single digit at the row border, or when its neighbors cannot absorb the displaced digit.
+    bool init_forced_tiles_(int const idx, int const d)
+    {
+        auto const& region = grid_.regions()[idx];
+        auto&       forced = region_tiles_[idx].forced[d];
+        auto&       zone   = region_tiles_[idx].zone[d];
+
+        auto const to_idx   = [](int r, int c) { return r * N + c; };
+        auto const in_range = [](int r, int c) { return r >= 0 && r < N && c >= 0 && c < N; };
+
+        for(auto [r, c]: region.cells())
+            if(!grid_.highlighted(r, c) && d > max_digit_(grid_.allowed_digits(r)))
+                forced.set(to_idx(r, c));
+
+        for(auto [r, c]: region.cells())
         {
-            auto const region_config =
-                std::views::transform(grid_.regions(), [](auto const& reg) { return reg.get_digit(); });
-            SPDLOG_INFO("Trying region configuration: {}", region_config);
+            if(!forced.test(to_idx(r, c)))
+                continue;
 
-            if(try_grid_configuration_())
+            if(c == 1 || c == N - 2)
+                return false;
+
+            int headroom = 0;
+            for(auto [dr, dc]: std::array<std::pair<int, int>, 4>{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}})
             {
+                int const nr = r + dr;
+                int const nc = c + dc;
+                if(!in_range(nr, nc) || grid_.highlighted(nr, nc) || forced.test(to_idx(nr, nc)))
+                    continue;
+
+                int const min_digit = (grid_.region_index_array()[nr][nc] == idx) ? d : 1;
+                headroom += std::max(0, max_digit_(grid_.allowed_digits(nr)) - min_digit);
+            }
+            if(headroom < d)
+                return false;
+
+            for(auto [dr, dc]: std::array<std::pair<int, int>, 6>{{{1, 0}, {-1, 0}, {0, 1}, {0, 2}, {0, -1}, {0, -2}}})
+                if(in_range(r + dr, c + dc))
+                    zone.set(to_idx(r + dr, c + dc));
+        }
+
+        return (forced & zone).none();
+    }
+
+    constexpr bool try_region_configuration_()
+    {
+        auto region_digits = first_region_digits_();
+
+        while(next_region_configuration_(region_digits))
+        {
+            stats_.report_progress([&] { return region_progress_(region_digits); });
+
+            set_region_digits_(region_digits);
+            SPDLOG_INFO("Trying region configuration: {}", region_digits);
+
+            auto const started = stats_.region_started();
+            bool const solved  = try_grid_configuration_();
+            stats_.region_finished(started);
+
+            if(solved)
+            {
+                remove_checkpoint_();
                 return true;
             }
-            return false;
+            save_checkpoint_(region_digits);
+        }
+
+        remove_checkpoint_();
+        set_region_digits_(region_digits);
+        return false;
+    }
+
+    // The configuration the region search advances from: all zeros, or the one of the checkpoint to resume after.
+    auto first_region_digits_() const -> std::vector<uint8_t>
+    {
+        if(!resume_digits_.empty())
+            return resume_digits_;
+        return std::vector<uint8_t>(grid_.regions().size());
+    }
+
+    void save_checkpoint_(std::span<uint8_t const> region_digits)
+    {
+        auto const now = checkpoint_clock::now();
+        if(checkpoint_path_.empty() || now - last_checkpoint_ < checkpoint_interval_)
+            return;
+
+        last_checkpoint_ = now;
+        number_cross_checkpoint checkpoint{N, grid_.fingerprint(), {region_digits.begin(), region_digits.end()}};
+        for(auto const& digits: reported_)
+            checkpoint.reported.emplace_back(digits.begin(), digits.end());
+        if(!checkpoint.save(checkpoint_path_))
+            SPDLOG_WARN("Cannot write checkpoint {}", checkpoint_path_.string());
+    }
+
+    void remove_checkpoint_() const noexcept
+    {
+        if(!checkpoint_path_.empty())
+            number_cross_checkpoint::remove(checkpoint_path_);
+    }
+
+    // Advances `region_digits` to the next assignment where neighbor regions differ, in the order of a depth-first
+    // search over regions in `region_order_` and their digits. All zeros is the state before the first and after the
+    // last assignment.
+    constexpr bool next_region_configuration_(std::vector<uint8_t>& region_digits) const noexcept
+    {
+        int const regions_sz = region_digits.size();
+        int       pos        = region_digits[region_order_.front()] == 0 ? 0 : regions_sz - 1;
+
+        while(pos >= 0)
+        {
+            auto const region_idx = region_order_[pos];
+            auto&      digit      = region_digits[region_idx];
+            digit                 = next_region_digit_(region_idx, digit + 1, region_digits);
+
+            if(digit == 0)
+                --pos;
+            else if(pos + 1 == regions_sz)
+                return true;
+            else
+                ++pos;
         }
 
-        SPDLOG_DEBUG("Trying setting region {} cells digit", region_idx);
+        return false;
+    }
 
-        auto& region = grid_.regions()[region_idx];
+    // Fraction of the region search space before `region_digits`, reading the digit ranks along `region_order_` as a
+    // mixed-radix number. Assignments skipped for neighbor conflicts make it an estimate.
+    double region_progress_(std::span<uint8_t const> region_digits) const noexcept
+    {
+        double fraction = 0.0;
+        double weight   = 1.0;
+        for(auto const idx: region_order_)
+        {
+            auto const domain = grid_.regions()[idx].get_allowed_digits();
+            auto const below  = domain.to_ulong() & ((1ul << region_digits[idx]) - 1);
+
+            weight   /= std::max<size_t>(domain.count(), 1);
+            fraction += weight * std::popcount(below);
+        }
+        return fraction;
+    }
+
+    // Smallest digit from `first_digit` allowed for the region, not used by an assigned neighbor and whose forced tiles
+    // do not clash with those of assigned regions, or 0 if none.
+    constexpr uint8_t next_region_digit_(int const region_idx, int const first_digit,
+                                         std::span<uint8_t const> region_digits) const noexcept
+    {
+        auto const& region = grid_.regions()[region_idx];
 
         std::bitset<10> const region_allowed_digits = region.get_allowed_digits();
 
-        for(int curr_digit = 1; curr_digit < 10; ++curr_digit)
+        for(int curr_digit = first_digit; curr_digit < 10; ++curr_digit)
         {
             auto const is_digit_allowed = region_allowed_digits.test(curr_digit);
             SPDLOG_DEBUG("Trying digit {} for region {}, allowed: {}", curr_digit, region_idx, is_digit_allowed);
             if(!is_digit_allowed)
                 continue;
 
-            bool valid_digit = true;
-            for(auto neighbor_idx: region.neighbors())
-            {
-                auto const& neighbor_region = grid_.regions()[neighbor_idx];
-                auto const  neighbor_digit  = neighbor_region.get_digit();
-                if(neighbor_digit == 0)
-                    continue;
-
-                if(neighbor_digit == curr_digit)
-                {
-                    SPDLOG_DEBUG("Digit {} is already used by neighbor region {}", curr_digit, neighbor_idx);
-                    valid_digit = false;
-                    break;
-                }
-            }
+            auto const is_neighbor_digit = [&](auto neighbor_idx) { return region_digits[neighbor_idx] == curr_digit; };
+            if(std::ranges::any_of(region.neighbors(), is_neighbor_digit))
+                continue;
 
-            if(!valid_digit)
+            auto const& forced        = region_tiles_[region_idx].forced[curr_digit];
+            auto const  is_tile_clash = [&](int const idx)
+            {
+                auto const digit = region_digits[idx];
+                return idx != region_idx && digit != 0 && (forced & region_tiles_[idx].zone[digit]).any();
+            };
+            if(forced.any() && std::ranges::any_of(std::views::iota(0, int(region_digits.size())), is_tile_clash))
                 continue;
 
-            SPDLOG_DEBUG("Setting digit {} for region {}, allowed", curr_digit, region_idx);
+            return curr_digit;
+        }
+
+        return 0;
+    }
 
-            region.set_digit(curr_digit);
+    constexpr void set_region_digits_(std::span<uint8_t const> region_digits) noexcept
+    {
+        for(size_t idx = 0; idx < region_digits.size(); ++idx)
+        {
+            auto& region = grid_.regions()[idx];
+            region.set_digit(region_digits[idx]);
             for(auto [r, c]: region.cells())
-                grid_(r, c) = curr_digit;
+                grid_.set_digit(r, c, region_digits[idx]);
+        }
+    }
 
-            if(try_region_configuration_(region_idx + 1))
-                return true;
+    // Column past the last digit of the number of `Row` closing once the search reaches `col`, if one does.
+    template<size_t Row>
+    constexpr auto closed_number_end_(int const col) const noexcept -> std::optional<int>
+    {
+        if(col >= N)
+            return grid_.blocked(Row, N - 1) ? N - 1 : N;
+        if(col > 0 && col < N - 1 && grid_.blocked(Row, col))
+            return col;
+        return std::nullopt;
+    }
+
+    template<size_t Row>
+    constexpr auto get_previous_number_digits_(int const col = N) const noexcept -> std::optional<number_digits>
+    {
+        auto const closed_end = closed_number_end_<Row>(col);
+        if(!closed_end.has_value())
+            return std::nullopt;
+
+        int const end_col   = *closed_end;
+        int       start_col = end_col;
+        while(start_col > 0 && !grid_.blocked(Row, start_col - 1))
+            --start_col;
+
+        number_digits res{.size = static_cast<size_t>(end_col - start_col)};
+        grid_.unpack_digits(Row, start_col, std::span{res.buffer}.first(res.size));
+        return res;
+    }
+
+    // Validates a closed number of `Row` with a table probe, or with the predicate when its length is not indexed.
+    template<size_t Row>
+    constexpr auto check_number_(std::span<uint8_t const> digits) noexcept -> std::tuple<bool, int64_t>
+    {
+        auto const& candidates = (*candidates_)[Row];
+
+        std::tuple<bool, int64_t> res{};
+        if(!candidates.is_indexed(digits.size()))
+            res = grid_.template predicate<Row>()(digits);
+        else
+        {
+            auto const x = std::ranges::fold_left(digits, int64_t{}, [](auto acc, auto c) { return 10 * acc + c; });
+            res          = {candidates.contains(x, digits.size()), x};
         }
 
-        region.set_digit(0);
-        for(auto [r, c]: region.cells())
-            grid_(r, c) = 0;
+        stats_.number_checked(Row, std::get<0>(res));
+        return res;
+    }
 
-        return false;
+    // Continues the number of `Row` running up to `col` from the one up to `col - 1`, whose digits are final by now.
+    // The search visits `col == N` last, to close the number at the row end.
+    template<size_t Row>
+    constexpr void step_number_(int const col) noexcept
+    {
+        assert(col >= 0 && col <= N);
+
+        auto const& pred   = grid_.template predicate<Row>();
+        auto&       number = running_[Row][col];
+        if(col == 0 || grid_.blocked(Row, col - 1))
+        {
+            number = {.value = 0, .state = pred.initial_state(), .len = 0};
+            return;
+        }
+
+        auto const& prev  = running_[Row][col - 1];
+        auto const  digit = grid_(Row, col - 1);
+
+        number.value = 10 * prev.value + digit;
+        number.len   = prev.len + 1;
+        number.state = (prev.state == kDeadState || !grid_.allowed_digits(Row).test(digit))
+                           ? kDeadState
+                           : pred.next_state(prev.state, digit);
     }
 
+    // Validity and value of the number of `Row` closing at `col`, if one does.
     template<size_t Row>
-    constexpr auto get_previous_number_digits_(int end_col = N) const noexcept
-        -> std::optional<std::span<uint8_t const>>
+    constexpr auto close_number_(int const col) noexcept -> std::optional<std::tuple<bool, int64_t>>
     {
-        end_col = std::min(end_col, static_cast<int>(N));
-        // pre-condition
-        if(!(end_col == N || (end_col > 0 && end_col < N - 1 && grid_.blocked(Row, end_col))))
-            return std::nullopt;
+        if constexpr(kRunsAutomaton<Row>)
+        {
+            auto const closed_end = closed_number_end_<Row>(col);
+            if(!closed_end.has_value())
+                return std::nullopt;
+
+            auto const& number = running_[Row][*closed_end];
+            bool const  valid  = number.len >= 2 && number.state != kDeadState &&
+                                grid_.template predicate<Row>().accepts(number.state);
+
+            stats_.number_checked(Row, valid);
+            return std::tuple{valid, number.value};
+        }
+        else
+        {
+            auto const number = get_previous_number_digits_<Row>(col);
+            if(!number.has_value())
+                return std::nullopt;
+
+            return check_number_<Row>(number->digits());
+        }
+    }
 
-        if(end_col == N && grid_.blocked(Row, N - 1))
-            --end_col;
+    // Whether the number of `Row` running on past `col` can still become valid. Its digits before `col` are final.
+    template<size_t Row>
+    constexpr bool can_extend_number_(int const col) noexcept
+    {
+        if(col == 0 || grid_.blocked(Row, col) || grid_.blocked(Row, col - 1))
+            return true;
+
+        if constexpr(kRunsAutomaton<Row>)
+        {
+            auto const& number = running_[Row][col];
+            bool const  valid  = number.state != kDeadState &&
+                                grid_.template predicate<Row>().can_extend_from(number.state, N - col) &&
+                                (*candidates_)[Row].has_extension(number.value, number.len, N - col + number.len);
+
+            stats_.prefix_checked(Row, valid);
+            return valid;
+        }
 
-        int start_col = end_col;
+        int start_col = col - 1;
         while(start_col > 0 && !grid_.blocked(Row, start_col - 1))
             --start_col;
 
-        auto const cell_row = std::span<uint8_t const>(grid_.template row<Row>());
-        return cell_row.subspan(start_col, end_col - start_col);
+        std::array<uint8_t, N> buffer{};
+        auto const             digits = std::span{buffer}.first(col - start_col);
+        grid_.unpack_digits(Row, start_col, digits);
+        bool valid = std::ranges::all_of(digits, [&](auto d) { return grid_.allowed_digits(Row).test(d); });
+
+        if constexpr(CPrefixRowPredicate<predicate_type_<Row>>)
+            valid = valid && grid_.template predicate<Row>().can_extend(digits, N - col);
+
+        if(valid)
+        {
+            auto const prefix =
+                std::ranges::fold_left(digits, int64_t{}, [](auto acc, auto c) { return 10 * acc + c; });
+            valid = (*candidates_)[Row].has_extension(prefix, digits.size(), N - start_col);
+        }
+
+        stats_.prefix_checked(Row, valid);
+        return valid;
     }
 
     template<size_t Row = 0>
     constexpr bool try_grid_configuration_(int const col = 0, int const prev_tile_col = -1)
     {
+        if constexpr(Row < N)
+            stats_.node(Row);
+
         if constexpr(Row == 0)
         {
             if(col >= N)
@@ -191,27 +832,36 @@ private:
         }
         else if constexpr(Row < N)
         {
-            auto const prev_number = get_previous_number_digits_<Row - 1>(col);
+            if constexpr(kRunsAutomaton<Row - 1>)
+                step_number_<Row - 1>(col);
+
+            auto const prev_number = close_number_<Row - 1>(col);
             if(prev_number.has_value())
             {
-                auto const& predicate    = grid_.template predicate<Row - 1>();
-                auto const [is_valid, x] = predicate(prev_number.value());
+                auto const [is_valid, x] = *prev_number;
                 if(!is_valid)
                     return false;
 
-                auto [_, is_inserted] = unique_numbers_.insert(x);
-                if(!is_inserted)
+                if(!unique_numbers_.insert(x))
+                {
+                    ++collisions_;
+                    stats_.unique_collision();
                     return false;
+                }
 
-                if(col >= N && try_grid_configuration_<Row + 1>())
-                    return true;
-                else if(try_grid_configuration_<Row>(col + 1, prev_tile_col))
+                // The number closing at the row end is the last one, and the search moves on to the next row.
+                bool const is_solved = (col >= N) ? try_next_row_<Row + 1>()
+                                                  : try_grid_configuration_<Row>(col + 1, prev_tile_col);
+                if(is_solved)
                     return true;
 
-                unique_numbers_.erase(x);
+                unique_numbers_.pop_back();
             }
             else
             {
+                if(!can_extend_number_<Row - 1>(col))
+                    return false;
+
                 if(!grid_.blocked(Row - 1, col) && try_put_tile_<Row>(col, prev_tile_col))
                     return true;
 
@@ -225,7 +875,6 @@ private:
         {
             SPDLOG_DEBUG("Row={}: Verifying last row of completed grid:\n{}", N, grid_);
 
-            static constexpr size_t             kMaxRowNumbers = (N + 1) / 3;
             std::array<int64_t, kMaxRowNumbers> row_numbers_buffer{};
             size_t                              row_numbers_size = 0;
 
@@ -234,8 +883,7 @@ private:
                 auto const prev_number = get_previous_number_digits_<N - 1>(col);
                 if(prev_number.has_value())
                 {
-                    auto const& predicate    = grid_.template predicate<N - 1>();
-                    auto const [is_valid, x] = predicate(prev_number.value());
+                    auto const [is_valid, x] = check_number_<N - 1>(prev_number->digits());
 
                     if(!is_valid)
                         return false;
@@ -246,26 +894,81 @@ private:
 
             auto const row_numbers = std::span<int64_t const>(row_numbers_buffer.data(), row_numbers_size);
 
-            auto const it =
-                std::ranges::find_if(row_numbers, [&](auto const& x) { return !unique_numbers_.insert(x).second; });
-            if(it != std::ranges::end(row_numbers))
+            auto const unique_size = unique_numbers_.size();
+            if(std::ranges::any_of(row_numbers, [&](auto const& x) { return !unique_numbers_.insert(x); }))
             {
-                auto const m = std::distance(row_numbers.begin(), it);
-                for(auto const& x: row_numbers.subspan(0, m))
-                    unique_numbers_.erase(x);
+                ++collisions_;
+                stats_.unique_collision();
+                unique_numbers_.rollback(unique_size);
                 return false;
             }
 
-            return true;
+            if(!on_solution_)
+                return true;
+
+            ++completions_;
+
+            std::array<uint64_t, N> digits{};
+            for(size_t r = 0; r < N; ++r)
+                digits[r] = grid_.row(r).digits;
+
+            bool stop = false;
+            if(reported_.insert(digits).second)
+            {
+                ++solutions_;
+                stop = !on_solution_(grid_, unique_numbers_) || solutions_ >= max_solutions_;
+            }
+            if(!stop)
+                unique_numbers_.rollback(unique_size);
+            return stop;
         }
     }
 
+    // Searches the rows from `Row` on, skipping states already known to have no completion. Failures involving a
+    // uniqueness collision depend on the numbers above and cancelled searches prove nothing, so neither is recorded,
+    // and neither are searches that went on after completing the grid.
+    template<size_t Row>
+    bool try_next_row_()
+    {
+        if constexpr(Row < N)
+        {
+            if(dead_ends_->enabled())
+            {
+                typename dead_ends_type::key_type key{};
+                key[0] = (uint64_t{Row} << 16) | grid_.row(Row - 1).blocked;
+                key[1] = grid_.row(Row - 1).digits;
+                for(size_t r = Row; r < N; ++r)
+                    key[2 + r - Row] = grid_.row(r).digits;
+
+                if(dead_ends_->contains(key))
+                {
+                    stats_.dead_end_hit(Row);
+                    return false;
+                }
+
+                auto const collisions  = collisions_;
+                auto const completions = completions_;
+                if(try_grid_configuration_<Row>())
+                    return true;
+
+                if(collisions_ == collisions && completions_ == completions && !is_cancelled_())
+                    dead_ends_->insert(key);
+                return false;
+            }
+        }
+
+        return try_grid_configuration_<Row>();
+    }
+
     template<size_t Row>
     constexpr bool try_put_tile_(int const col, int const prev_tile_col)
     {
         SPDLOG_DEBUG("Row={}, col={}, prev_tile_col={}: Trying to place tile at ({}, {})", Row, col, prev_col, Row, col,
                      prev_col, Row, col);
 
+        if(is_cancelled_())
+            return false;
+
         if((col != 0 && col - prev_tile_col < 3) || (col != N - 1 && N - col < 3) || grid_.highlighted(Row, col))
         {
             SPDLOG_DEBUG("Row={}, col={}, prev_tile_col={}: Skipping column. Highlighted or too close to previous.",
@@ -273,44 +976,34 @@ private:
             return false;
         }
 
-        auto const digit        = grid_(Row, col);
-        auto const region_digit = grid_.region_of(Row, col).get_digit();
+        stats_.tile_tried(Row);
+
+        auto const digit = grid_(Row, col);
+        auto const mark  = trail_.size();
 
-        grid_(Row, col)         = 0;
-        grid_.blocked(Row, col) = true;
+        save_rows_<Row>();
+        grid_.set_digit(Row, col, 0);
+        grid_.set_blocked(Row, col, true);
 
-        for(auto const& partition: grid_cross_partitions::get(digit))
+        auto const [closed, headroom] = tile_sides_<Row>(col);
+        for(auto const& partition: grid_cross_partitions::get(digit, closed))
         {
-            bool const valid_partition = is_valid_partition_<Row>(col, partition);
+            bool const valid_partition = grid_cross_partitions::fits(partition, headroom);
+            stats_.partition_tried(Row, valid_partition);
             if(!valid_partition)
                 continue;
 
-            qs::restorer_array<uint8_t, 4> rxs(qs::defer_restore);
+            auto const tiled = trail_.size();
+            save_rows_<Row>();
 
             if constexpr(Row > 0)
-            {
-                auto& top = grid_(Row - 1, col);
-                rxs.unchecked_push_back(top);
-                top += partition.top;
-            }
+                grid_.add_digit(Row - 1, col, partition.top);
             if constexpr(Row + 1 < N)
-            {
-                auto& bottom = grid_(Row + 1, col);
-                rxs.unchecked_push_back(bottom);
-                bottom += partition.bottom;
-            }
+                grid_.add_digit(Row + 1, col, partition.bottom);
             if(col > 0)
-            {
-                auto& left = grid_(Row, col - 1);
-                rxs.unchecked_push_back(left);
-                left += partition.left;
-            }
+                grid_.add_digit(Row, col - 1, partition.left);
             if(col + 1 < N)
-            {
-                auto& right = grid_(Row, col + 1);
-                rxs.unchecked_push_back(right);
-                right += partition.right;
-            }
+                grid_.add_digit(Row, col + 1, partition.right);
 
 #ifndef NDEBUG
             check_digit_value_invariants_();
@@ -319,11 +1012,10 @@ private:
             if(try_grid_configuration_<Row>(col + 1, col))
                 return true;
 
-            rxs.complete();
+            undo_to_(tiled);
         }
 
-        grid_(Row, col)         = digit;
-        grid_.blocked(Row, col) = false;
+        undo_to_(mark);
 
         SPDLOG_DEBUG("Row={}, col={}, prev_tile_col={}: Failed to place tile at ({}, {})", Row, col, prev_col, Row, col,
                      prev_col, Row, col);
@@ -331,10 +1023,30 @@ private:
         return false;
     }
 
+    // A tile on `Row` changes its own row and the ones above and below.
+    template<size_t Row>
+    constexpr void save_rows_()
+    {
+        if constexpr(Row > 0)
+            trail_.push_back({Row - 1, grid_.row(Row - 1)});
+        trail_.push_back({Row, grid_.row(Row)});
+        if constexpr(Row + 1 < N)
+            trail_.push_back({Row + 1, grid_.row(Row + 1)});
+    }
+
+    // Restores the rows saved since the trail had `mark` entries, latest first.
+    constexpr void undo_to_(size_t const mark) noexcept
+    {
+        for(; trail_.size() > mark; trail_.pop_back())
+            grid_.set_row(trail_.back().row, trail_.back().state);
+    }
+
     constexpr void check_digit_value_invariants_() const noexcept
     {
-        auto const is_valid_digit = [](auto const d) { return d >= 0 && d < 10; };
-        auto const valid          = std::ranges::all_of(grid_.digits_array() | std::views::join, is_valid_digit);
+        bool valid = true;
+        for(int r = 0; r < N; ++r)
+            for(int c = 0; c < N; ++c)
+                valid &= grid_(r, c) < 10;
         if(!valid)
         {
             SPDLOG_CRITICAL("Invalid digit in grid: \n{}", grid_);
@@ -342,41 +1054,28 @@ private:
         }
     }
 
+    // The sides of a tile at (`Row`, `col`) that cannot take any of its digit, and how much the others can take.
     template<size_t Row>
-    constexpr bool is_valid_partition_(int const col, grid_cross_partition const& part) const noexcept
+    constexpr auto tile_sides_(int const col) const noexcept -> std::tuple<uint8_t, grid_cross_partition>
     {
-        auto is_valid_sum = [&](int r, int c, int const val)
-        { return (val == 0 || !(grid_.highlighted(r, c) || grid_.blocked(r, c))) && (grid_(r, c) + val < 10); };
+        uint8_t              closed   = 0;
+        grid_cross_partition headroom = {};
 
-        if constexpr(Row == 0)
+        auto const side = [&](int const r, int const c, uint8_t const side_bit, uint8_t& room)
         {
-            if(part.top > 0)
-                return false;
-        }
-        else
-        {
-            if(!is_valid_sum(Row - 1, col, part.top))
-                return false;
-        }
-
-        if constexpr(Row == N - 1)
-        {
-            if(part.bottom > 0)
-                return false;
-        }
-        else
-        {
-            if(!is_valid_sum(Row + 1, col, part.bottom))
-                return false;
-        }
-
-        if((col == 0 && part.left > 0) || !is_valid_sum(Row, col - 1, part.left))
-            return false;
+            if(r < 0 || r >= N || c < 0 || c >= N || grid_.highlighted(r, c) || grid_.blocked(r, c))
+                closed |= side_bit;
+            else
+                room = 9 - grid_(r, c);
+        };
 
-        if((col == N - 1 && part.right > 0) || !is_valid_sum(Row, col + 1, part.right))
-            return false;
+        int const row = Row;
+        side(row, col - 1, kLeftSide, headroom.left);
+        side(row - 1, col, kTopSide, headroom.top);
+        side(row, col + 1, kRightSide, headroom.right);
+        side(row + 1, col, kBottomSide, headroom.bottom);
 
-        return true;
+        return {closed, headroom};
     }
 };
 
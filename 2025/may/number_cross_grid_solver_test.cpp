@@ -0,0 +1,160 @@
+#include "2025/may/number_cross_grid_solver.h"
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "2025/may/number_cross_dead_ends.h"
+#include "2025/may/number_cross_grid.h"
+#include "2025/may/number_cross_grid_predicates.h"
+
+
+namespace
+{
+
+// The 5x5 example board, whose unique solution is known.
+// clang-format off
+constexpr auto kPredicates5 = std::make_tuple(
+    is_multiple_of<11>{},
+    is_multiple_of<14>{},
+    is_multiple_of<28>{},
+    is_multiple_of<101>{},
+    is_multiple_of<2025>{}
+);
+
+constexpr auto kRegions5 = std::array<std::array<uint8_t, 5>, 5>{
+    {{0, 0, 0, 0, 0},
+     {1, 0, 0, 0, 0},
+     {1, 1, 0, 0, 0},
+     {2, 1, 1, 0, 0},
+     {2, 2, 1, 1, 0}}};
+
+constexpr auto kHighlighted5 = std::array<std::array<bool, 5>, 5>{
+    {{1, 1, 0, 0, 0},
+     {1, 0, 0, 0, 0},
+     {0, 0, 0, 0, 0},
+     {0, 0, 0, 0, 1},
+     {0, 0, 0, 1, 1}}};
+// clang-format on
+
+std::vector<int64_t> const kSolution5{55, 56, 84, 88, 2576, 5555, 99225};
+
+template<class Solver>
+std::vector<int64_t> sorted_numbers(Solver const& solver)
+{
+    std::vector<int64_t> res(solver.get_unique_numbers().begin(), solver.get_unique_numbers().end());
+    std::ranges::sort(res);
+    return res;
+}
+
+} // namespace
+
+
+TEST(NumberCrossSolverTest, SolvesExample)
+{
+    number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+
+    ASSERT_TRUE(solver.solve());
+    EXPECT_EQ(sorted_numbers(solver), kSolution5);
+}
+
+TEST(NumberCrossSolverTest, SolvesExampleInParallel)
+{
+    number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+
+    ASSERT_TRUE(solver.solve_parallel(2));
+    EXPECT_EQ(sorted_numbers(solver), kSolution5);
+}
+
+TEST(NumberCrossSolverTest, ExampleHasUniqueSolution)
+{
+    number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+
+    std::vector<std::vector<int64_t>> solutions;
+    auto const count = solver.solve_all(
+        [&](auto const&, auto const& numbers)
+        {
+            solutions.emplace_back(numbers.begin(), numbers.end());
+            std::ranges::sort(solutions.back());
+            return true;
+        });
+
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(solutions, std::vector<std::vector<int64_t>>{kSolution5});
+}
+
+TEST(NumberCrossSolverTest, DeadEndTableRecordsAndHitsRowStates)
+{
+    number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+    number_cross_grid_solver solver(grid);
+
+    ASSERT_TRUE(solver.solve());
+    EXPECT_EQ(sorted_numbers(solver), kSolution5);
+    EXPECT_GT(solver.get_dead_ends().size(), 0);
+    EXPECT_GT(solver.get_dead_ends().hits(), 0);
+    EXPECT_EQ(solver.get_dead_ends().evictions(), 0);
+}
+
+TEST(NumberCrossSolverTest, DeadEndTableDoesNotChangeTheSolution)
+{
+    for(size_t const budget: {size_t{0}, size_t{4} << 10})
+    {
+        SCOPED_TRACE(budget);
+
+        number_cross_grid        grid(kPredicates5, kRegions5, kHighlighted5);
+        number_cross_grid_solver solver(grid);
+        solver.set_dead_end_budget(budget);
+
+        ASSERT_TRUE(solver.solve());
+        EXPECT_EQ(sorted_numbers(solver), kSolution5);
+        if(budget == 0)
+            EXPECT_EQ(solver.get_dead_ends().size(), 0);
+        else
+            EXPECT_GT(solver.get_dead_ends().evictions(), 0);
+    }
+}
+
+TEST(NumberCrossSolverTest, DeadEndTableEvictsLeastRecentlyUsed)
+{
+    using table_type = dead_end_table<2>;
+
+    // Room for a handful of entries: the size stops growing once they are taken.
+    table_type table(1024);
+    for(uint64_t k = 0; table.size() == k; ++k)
+        table.insert({k, 0});
+    auto const capacity = table.size();
+    ASSERT_GT(capacity, 2);
+    table.clear();
+
+    // The table has to agree with a list kept in use order.
+
+    std::list<table_type::key_type> model;
+    std::mt19937_64                 rng{2025};
+    for(int i = 0; i < 10'000; ++i)
+    {
+        table_type::key_type const key{rng() % (2 * capacity), 1};
+
+        auto const it       = std::ranges::find(model, key);
+        bool const is_known = it != model.end();
+        ASSERT_EQ(table.contains(key), is_known);
+        if(is_known)
+            model.splice(model.begin(), model, it);
+        else
+        {
+            table.insert(key);
+            model.push_front(key);
+            if(model.size() > capacity)
+                model.pop_back();
+        }
+        ASSERT_EQ(table.size(), model.size());
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef NUMBER_CROSS_NUMBER_SET_H
+#define NUMBER_CROSS_NUMBER_SET_H
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+
+// Fixed-capacity open-addressing set of positive numbers, undone in reverse insertion order. Numbers are only removed
+// last-in first-out, so linear probing needs no tombstones. Iterates in insertion order.
+template<size_t Capacity>
+class flat_number_set
+{
+public:
+    static constexpr size_t kTableSize = std::bit_ceil(2 * Capacity);
+
+    static_assert(kTableSize <= size_t{1} << 16, "slot indexes are stored as 16 bits");
+
+    constexpr bool insert(int64_t const x) noexcept
+    {
+        assert(x > 0 && size_ < Capacity);
+
+        auto slot = hash_(x);
+        for(; table_[slot] != kEmpty; slot = (slot + 1) & kMask)
+            if(table_[slot] == x)
+                return false;
+
+        table_[slot]   = x;
+        slots_[size_]  = slot;
+        values_[size_] = x;
+        ++size_;
+        return true;
+    }
+
+    constexpr bool contains(int64_t const x) const noexcept
+    {
+        for(auto slot = hash_(x); table_[slot] != kEmpty; slot = (slot + 1) & kMask)
+            if(table_[slot] == x)
+                return true;
+        return false;
+    }
+
+    // Removes the most recently inserted number.
+    constexpr void pop_back() noexcept
+    {
+        assert(size_ > 0);
+        table_[slots_[--size_]] = kEmpty;
+    }
+
+    // Removes the numbers inserted after the set had `size` elements.
+    constexpr void rollback(size_t const size) noexcept
+    {
+        while(size_ > size)
+            pop_back();
+    }
+
+    constexpr void clear() noexcept { rollback(0); }
+
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool   empty() const noexcept { return size_ == 0; }
+
+    constexpr auto begin() const noexcept { return values_.begin(); }
+    constexpr auto end() const noexcept { return values_.begin() + size_; }
+
+private:
+    static constexpr int64_t kEmpty = 0;
+    static constexpr size_t  kMask  = kTableSize - 1;
+
+    // Fibonacci hashing: the top bits of the product spread consecutive numbers over the table.
+    static constexpr size_t hash_(int64_t const x) noexcept
+    {
+        return (static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(kTableSize));
+    }
+
+    std::array<int64_t, kTableSize> table_{};
+    std::array<int64_t, Capacity>   values_{};
+    std::array<uint16_t, Capacity>  slots_{};
+    size_t                          size_{0};
+};
+
+
+#endif // NUMBER_CROSS_NUMBER_SET_H
@@ -0,0 +1,241 @@
+#ifndef NUMBER_CROSS_PUZZLE_H
+#define NUMBER_CROSS_PUZZLE_H
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "2025/may/number_cross_grid_predicates.h"
+#include "2025/may/number_cross_runtime_predicates.h"
+
+
+// A number cross puzzle read at run time. The text format has three sections, each starting with its name on a line
+// of its own, and ignores blank lines and lines starting with '#':
+//
+//     clues
+//     is_multiple_of 11          <- one predicate per row, with its parameter if it takes one
+//     ...
+//     regions
+//     0 0 1 1 ...                <- region index of every cell, one row per line
+//     ...
+//     highlighted
+//     1 0 0 0 ...                <- 1 for highlighted cells
+//     ...
+struct number_cross_puzzle
+{
+    std::vector<any_row_predicate>    clues{};
+    std::vector<std::vector<uint8_t>> regions{};
+    std::vector<std::vector<uint8_t>> highlighted{};
+
+    size_t size() const noexcept { return clues.size(); }
+
+    static number_cross_puzzle parse(std::istream& in)
+    {
+        number_cross_puzzle res;
+
+        std::vector<std::vector<uint8_t>>* cells   = nullptr;
+        bool                               is_clue = false;
+
+        size_t line_no = 0;
+        for(std::string line; std::getline(in, line);)
+        {
+            ++line_no;
+
+            std::istringstream stream(line);
+            std::string        word;
+            if(!(stream >> word) || word.front() == '#')
+                continue;
+
+            auto const fail = [&](std::string const& what)
+            { throw std::invalid_argument{fmt::format("line {}: {}", line_no, what)}; };
+
+            if(word == "clues" || word == "regions" || word == "highlighted")
+            {
+                is_clue = (word == "clues");
+                cells   = (word == "regions") ? &res.regions : (word == "highlighted" ? &res.highlighted : nullptr);
+                continue;
+            }
+
+            if(is_clue)
+            {
+                std::string parameter;
+                stream >> parameter;
+                if(std::string extra; stream >> extra)
+                    fail(fmt::format("unexpected '{}' after the clue", extra));
+                try
+                {
+                    res.clues.push_back(any_row_predicate::parse(word, parameter));
+                }
+                catch(std::invalid_argument const& e)
+                {
+                    fail(e.what());
+                }
+            }
+            else if(cells != nullptr)
+            {
+                auto& row = cells->emplace_back();
+                for(stream.clear(), stream.str(line); stream >> word;)
+                {
+                    auto const* const last  = word.data() + word.size();
+                    int               value = 0;
+                    auto const [ptr, ec]    = std::from_chars(word.data(), last, value);
+                    if(ec == std::errc::invalid_argument || ptr != last)
+                        fail(fmt::format("'{}' is not a number", word));
+                    if(ec != std::errc{} || value < 0 || value > 255)
+                        fail(fmt::format("{} is out of range", word));
+                    row.push_back(value);
+                }
+            }
+            else
+                fail(fmt::format("'{}' outside of a section", word));
+        }
+
+        res.validate_();
+        return res;
+    }
+
+    // Whether the clues are those of `predicates`, row by row.
+    template<CTupleRowPredicates Tuple>
+    bool matches(Tuple const& predicates) const noexcept
+    {
+        return size() == std::tuple_size_v<Tuple> &&
+               [&]<size_t... Rows>(std::index_sequence<Rows...>)
+               { return ((clues[Rows] == any_row_predicate::of(std::get<Rows>(predicates))) && ...); }(
+                   std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+    }
+
+    template<size_t N>
+    auto region_array() const -> std::array<std::array<uint8_t, N>, N>
+    {
+        return to_array_<uint8_t, N>(regions);
+    }
+
+    template<size_t N>
+    auto highlighted_array() const -> std::array<std::array<bool, N>, N>
+    {
+        return to_array_<bool, N>(highlighted);
+    }
+
+    template<size_t N>
+    auto clue_tuple() const
+    {
+        return [&]<size_t... Rows>(std::index_sequence<Rows...>)
+        { return std::make_tuple(((void)Rows, clues[Rows])...); }(std::make_index_sequence<N>{});
+    }
+
+private:
+    template<class T, size_t N>
+    static auto to_array_(std::vector<std::vector<uint8_t>> const& cells) -> std::array<std::array<T, N>, N>
+    {
+        std::array<std::array<T, N>, N> res{};
+        for(size_t r = 0; r < N; ++r)
+            for(size_t c = 0; c < N; ++c)
+                res[r][c] = static_cast<T>(cells[r][c]);
+        return res;
+    }
+
+    // The grid assumes square maps, regions numbered from 0 without gaps, each one connected and within its size and
+    // neighbor capacity.
+    void validate_() const
+    {
+        auto const n = size();
+        if(n < 2)
+            throw std::invalid_argument{"expected at least two clues"};
+
+        for(auto const& [name, cells]: {std::pair{"regions", &regions}, std::pair{"highlighted", &highlighted}})
+        {
+            if(cells->size() != n || std::ranges::any_of(*cells, [&](auto const& row) { return row.size() != n; }))
+                throw std::invalid_argument{fmt::format("{} must be {}x{} like the clues", name, n, n)};
+        }
+
+        if(std::ranges::any_of(highlighted, [](auto const& row) { return std::ranges::max(row) > 1; }))
+            throw std::invalid_argument{"highlighted cells must be 0 or 1"};
+
+        size_t regions_sz = 0;
+        for(auto const& row: regions)
+            regions_sz = std::max<size_t>(regions_sz, std::ranges::max(row) + 1);
+
+        std::vector<size_t>              region_size(regions_sz);
+        std::vector<std::vector<size_t>> region_neighbors(regions_sz);
+        for(size_t r = 0; r < n; ++r)
+        {
+            for(size_t c = 0; c < n; ++c)
+            {
+                auto const idx = regions[r][c];
+                ++region_size[idx];
+
+                for(auto const [nr, nc]: {std::pair{r + 1, c}, std::pair{r, c + 1}})
+                {
+                    if(nr >= n || nc >= n || regions[nr][nc] == idx)
+                        continue;
+                    for(auto const [a, b]: {std::pair{idx, regions[nr][nc]}, std::pair{regions[nr][nc], idx}})
+                        if(!std::ranges::contains(region_neighbors[a], b))
+                            region_neighbors[a].push_back(b);
+                }
+            }
+        }
+
+        for(size_t idx = 0; idx < regions_sz; ++idx)
+        {
+            if(region_size[idx] == 0)
+                throw std::invalid_argument{fmt::format("region {} has no cells", idx)};
+            if(region_size[idx] > n * (n + 1) / 2)
+                throw std::invalid_argument{fmt::format("region {} has more than {} cells", idx, n * (n + 1) / 2)};
+            if(region_neighbors[idx].size() > n)
+                throw std::invalid_argument{fmt::format("region {} has more than {} neighbors", idx, n)};
+            if(connected_size_(idx) != region_size[idx])
+                throw std::invalid_argument{fmt::format("region {} is not connected", idx)};
+        }
+    }
+
+    // Cells reachable from the first cell of region `idx` without leaving it.
+    size_t connected_size_(size_t const idx) const
+    {
+        auto const n = size();
+
+        std::vector<std::pair<size_t, size_t>> stack;
+        std::vector<bool>                      visited(n * n);
+        for(size_t cell = 0; cell < n * n && stack.empty(); ++cell)
+        {
+            if(regions[cell / n][cell % n] == idx)
+            {
+                stack.emplace_back(cell / n, cell % n);
+                visited[cell] = true;
+            }
+        }
+
+        size_t count = 0;
+        while(!stack.empty())
+        {
+            auto const [r, c] = stack.back();
+            stack.pop_back();
+            ++count;
+
+            for(auto const [nr, nc]:
+                {std::pair{r + 1, c}, std::pair{r - 1, c}, std::pair{r, c + 1}, std::pair{r, c - 1}})
+            {
+                // Moving off the grid wraps around to a large index.
+                if(nr < n && nc < n && !visited[nr * n + nc] && regions[nr][nc] == idx)
+                {
+                    visited[nr * n + nc] = true;
+                    stack.emplace_back(nr, nc);
+                }
+            }
+        }
+        return count;
+    }
+};
+
+
+#endif // NUMBER_CROSS_PUZZLE_H
@@ -0,0 +1,140 @@
+#include "2025/may/number_cross_puzzle.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "2025/may/number_cross_grid.h"
+#include "2025/may/number_cross_grid_predicates.h"
+#include "2025/may/number_cross_grid_solver.h"
+#include "2025/may/number_cross_runtime_predicates.h"
+
+
+namespace
+{
+
+auto const kDataDir = std::filesystem::path{__FILE__}.parent_path();
+
+constexpr auto kPredicates5 = std::make_tuple(is_multiple_of<11>{}, is_multiple_of<14>{}, is_multiple_of<28>{},
+                                              is_multiple_of<101>{}, is_multiple_of<2025>{});
+
+number_cross_puzzle load(std::filesystem::path const& path)
+{
+    std::ifstream in(path);
+    return number_cross_puzzle::parse(in);
+}
+
+number_cross_puzzle parse(std::string const& text)
+{
+    std::istringstream in(text);
+    return number_cross_puzzle::parse(in);
+}
+
+// A valid 3x3 puzzle, or one with the sections given replaced.
+std::string puzzle_text(std::string const& clues   = "is_prime\nis_fibonacci\nis_multiple_of 3\n",
+                        std::string const& regions = "0 0 1\n0 1 1\n2 2 1\n",
+                        std::string const& marks   = "1 0 0\n0 0 0\n0 0 1\n")
+{
+    return "clues\n" + clues + "regions\n" + regions + "highlighted\n" + marks;
+}
+
+void expect_error(std::string const& text, std::string const& message)
+{
+    SCOPED_TRACE(text);
+    try
+    {
+        parse(text);
+        ADD_FAILURE() << "expected an error containing '" << message << "'";
+    }
+    catch(std::invalid_argument const& e)
+    {
+        EXPECT_NE(std::string{e.what()}.find(message), std::string::npos) << e.what();
+    }
+}
+
+} // namespace
+
+
+TEST(NumberCrossPuzzleTest, LoadsExample)
+{
+    auto const puzzle = load(kDataDir / "number-cross-5-example.txt");
+
+    ASSERT_EQ(puzzle.size(), 5);
+    EXPECT_TRUE(puzzle.matches(kPredicates5));
+    EXPECT_EQ(puzzle.clues[4], (any_row_predicate{any_row_predicate::kind::multiple_of, 2025}));
+    EXPECT_EQ(puzzle.regions[3], (std::vector<uint8_t>{2, 1, 1, 0, 0}));
+    EXPECT_EQ(puzzle.highlighted[4], (std::vector<uint8_t>{0, 0, 0, 1, 1}));
+}
+
+TEST(NumberCrossPuzzleTest, LoadsPuzzle)
+{
+    auto const puzzle = load(kDataDir / "number-cross-5-puzzle.txt");
+
+    ASSERT_EQ(puzzle.size(), 11);
+    EXPECT_FALSE(puzzle.matches(kPredicates5));
+}
+
+TEST(NumberCrossPuzzleTest, SolvesExampleWithRuntimeClues)
+{
+    auto const puzzle = load(kDataDir / "number-cross-5-example.txt");
+
+    number_cross_grid        grid(puzzle.clue_tuple<5>(), puzzle.region_array<5>(), puzzle.highlighted_array<5>());
+    number_cross_grid_solver solver(grid);
+    ASSERT_TRUE(solver.solve());
+
+    std::vector<int64_t> numbers(solver.get_unique_numbers().begin(), solver.get_unique_numbers().end());
+    std::ranges::sort(numbers);
+    EXPECT_EQ(numbers, (std::vector<int64_t>{55, 56, 84, 88, 2576, 5555, 99225}));
+}
+
+TEST(NumberCrossPuzzleTest, SkipsCommentsAndBlankLines)
+{
+    auto const puzzle = parse("# a comment\n\n" + puzzle_text("is_prime\n\n# between clues\nis_fibonacci\n"
+                                                              "is_multiple_of 3\n"));
+
+    ASSERT_EQ(puzzle.size(), 3);
+    EXPECT_EQ(puzzle.clues[1], (any_row_predicate{any_row_predicate::kind::fibonacci}));
+    EXPECT_EQ(puzzle.clues[2], (any_row_predicate{any_row_predicate::kind::multiple_of, 3}));
+}
+
+TEST(NumberCrossPuzzleTest, RejectsMalformedClues)
+{
+    expect_error(puzzle_text("is_prime\nis_square\nis_multiple_of 3\n"), "line 3: unknown predicate 'is_square'");
+    expect_error(puzzle_text("is_prime 2\nis_fibonacci\nis_multiple_of 3\n"), "is_prime takes no parameter");
+    expect_error(puzzle_text("is_prime\nis_fibonacci\nis_multiple_of\n"), "is_multiple_of needs a parameter");
+    expect_error(puzzle_text("is_prime\nis_fibonacci\nis_multiple_of 3x\n"), "invalid parameter '3x'");
+    expect_error(puzzle_text("is_prime\nis_fibonacci\nis_multiple_of 0\n"), "invalid parameter '0'");
+    expect_error(puzzle_text("is_prime\nis_fibonacci\nis_multiple_of 3 4\n"), "unexpected '4' after the clue");
+    expect_error("is_prime\n" + puzzle_text(), "line 1: 'is_prime' outside of a section");
+}
+
+TEST(NumberCrossPuzzleTest, RejectsMalformedCells)
+{
+    auto const clues = std::string{"is_prime\nis_fibonacci\nis_multiple_of 3\n"};
+
+    expect_error(puzzle_text(clues, "0 0 1\n0 x 1\n2 2 1\n"), "line 7: 'x' is not a number");
+    expect_error(puzzle_text(clues, "0 0 1\n0 1a 1\n2 2 1\n"), "line 7: '1a' is not a number");
+    expect_error(puzzle_text(clues, "0 0 1\n0 256 1\n2 2 1\n"), "line 7: 256 is out of range");
+    expect_error(puzzle_text(clues, "0 0 1\n0 -1 1\n2 2 1\n"), "line 7: -1 is out of range");
+}
+
+TEST(NumberCrossPuzzleTest, RejectsInvalidGrids)
+{
+    auto const clues = std::string{"is_prime\nis_fibonacci\nis_multiple_of 3\n"};
+
+    expect_error(puzzle_text("is_prime\n", "0\n", "0\n"), "expected at least two clues");
+    expect_error(puzzle_text(clues, "0 0 1\n0 1 1\n"), "regions must be 3x3 like the clues");
+    expect_error(puzzle_text(clues, "0 0 1\n0 1 1\n2 2\n"), "regions must be 3x3 like the clues");
+    expect_error(puzzle_text(clues, "0 0 1\n0 1 1\n2 2 1\n", "1 0 0\n0 0 0\n"), "highlighted must be 3x3");
+    expect_error(puzzle_text(clues, "0 0 1\n0 1 1\n2 2 1\n", "1 0 0\n0 2 0\n0 0 1\n"), "must be 0 or 1");
+    expect_error(puzzle_text(clues, "0 0 2\n0 2 2\n3 3 2\n"), "region 1 has no cells");
+    expect_error(puzzle_text(clues, "0 1 0\n0 1 1\n2 2 1\n"), "region 0 is not connected");
+    expect_error(puzzle_text(clues, "0 0 0\n0 0 0\n0 0 1\n"), "region 0 has more than 6 cells");
+}
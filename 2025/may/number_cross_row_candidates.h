@@ -0,0 +1,135 @@
+#ifndef NUMBER_CROSS_ROW_CANDIDATES_H
+#define NUMBER_CROSS_ROW_CANDIDATES_H
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "2025/may/number_cross_grid_predicates.h"
+
+
+// Sorted valid numbers of a row for each length, enumerated once from the digits its predicate allows. Lengths with
+// too many digit combinations are not indexed and are left to the predicate itself.
+class row_candidates
+{
+public:
+    static constexpr size_t kMaxLength = 18;
+
+    // Digit combinations enumerated at most per length.
+    static constexpr size_t kMaxEnumerated = size_t{1} << 20;
+
+    template<CRowPredicate Pred>
+    static row_candidates build(Pred const& pred, size_t const max_length)
+    {
+        row_candidates res;
+        res.numbers_.resize(std::min(max_length, kMaxLength) + 1);
+
+        std::bitset<10> const allowed = pred.allowed_digits();
+
+        std::array<uint8_t, 10> allowed_digits{};
+        size_t                  allowed_sz = 0;
+        for(uint8_t d = 1; d < 10; ++d)
+            if(allowed.test(d))
+                allowed_digits[allowed_sz++] = d;
+
+        size_t combinations = allowed_sz;
+        for(size_t len = 2; len < res.numbers_.size(); ++len)
+        {
+            combinations *= allowed_sz;
+            if(combinations > kMaxEnumerated)
+                break;
+
+            row_batch batch{.len = len};
+            enumerate_(pred, std::span{allowed_digits}.first(allowed_sz), batch, 0, 0, res.numbers_[len]);
+            check_batch_(pred, batch, res.numbers_[len]);
+            res.indexed_mask_ |= uint32_t{1} << len;
+        }
+
+        return res;
+    }
+
+    constexpr bool is_indexed(size_t const len) const noexcept { return (indexed_mask_ >> len) & 1; }
+
+    constexpr bool contains(int64_t const x, size_t const len) const noexcept
+    {
+        return std::ranges::binary_search(numbers_[len], x);
+    }
+
+    // Whether a valid number longer than `prefix_len` and at most `max_len` digits starts with `prefix`. Lengths that
+    // are not indexed count as possible.
+    constexpr bool has_extension(int64_t const prefix, size_t const prefix_len, size_t max_len) const noexcept
+    {
+        max_len = std::min(max_len, numbers_.size() - 1);
+
+        int64_t scale = 10;
+        for(size_t len = prefix_len + 1; len <= max_len; ++len, scale *= 10)
+        {
+            if(len < 2)
+                continue;
+            if(!is_indexed(len))
+                return true;
+
+            auto const& numbers = numbers_[len];
+            auto const  it      = std::ranges::lower_bound(numbers, prefix * scale);
+            if(it != numbers.end() && *it < (prefix + 1) * scale)
+                return true;
+        }
+
+        return false;
+    }
+
+    constexpr size_t size(size_t const len) const noexcept { return numbers_[len].size(); }
+
+private:
+    std::vector<std::vector<int64_t>> numbers_{};
+    uint32_t                          indexed_mask_{0};
+
+    // Appends digits in increasing order, so every length comes out sorted. Completed numbers are gathered into a
+    // batch and checked a batch at a time.
+    template<CRowPredicate Pred>
+    static void enumerate_(Pred const& pred, std::span<uint8_t const> allowed_digits, row_batch& batch,
+                           size_t const depth, int64_t const x, std::vector<int64_t>& out)
+    {
+        if(depth + 1 < batch.len)
+        {
+            for(auto const d: allowed_digits)
+            {
+                batch.digits[depth][batch.size] = d;
+                enumerate_(pred, allowed_digits, batch, depth + 1, 10 * x + d, out);
+            }
+            return;
+        }
+
+        for(auto const d: allowed_digits)
+        {
+            auto const lane           = batch.size++;
+            batch.digits[depth][lane] = d;
+            batch.numbers[lane]       = 10 * x + d;
+
+            if(batch.size == row_batch::kLanes)
+                check_batch_(pred, batch, out);
+
+            // The next lane starts from the same prefix.
+            for(size_t k = 0; k < depth; ++k)
+                batch.digits[k][batch.size] = batch.digits[k][lane];
+        }
+    }
+
+    template<CRowPredicate Pred>
+    static void check_batch_(Pred const& pred, row_batch& batch, std::vector<int64_t>& out)
+    {
+        row_batch::lane_flags is_valid{};
+        pred.check_batch(batch, is_valid);
+
+        for(size_t i = 0; i < batch.size; ++i)
+            if(is_valid[i])
+                out.push_back(batch.numbers[i]);
+        batch.size = 0;
+    }
+};
+
+
+#endif // NUMBER_CROSS_ROW_CANDIDATES_H
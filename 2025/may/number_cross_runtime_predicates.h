@@ -0,0 +1,200 @@
+#ifndef NUMBER_CROSS_RUNTIME_PRED_H
+#define NUMBER_CROSS_RUNTIME_PRED_H
+
+#include <array>
+#include <bitset>
+#include <charconv>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "2025/may/number_cross_grid_predicates.h"
+
+
+// `is_multiple_of` with the divisor known only at run time.
+struct is_multiple_of_value : row_predicate<is_multiple_of_value>
+{
+    int64_t n{1};
+
+    constexpr explicit is_multiple_of_value(int64_t const divisor) noexcept
+        : n{divisor}
+    {}
+
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return any_extension_range(prefix, remaining_len,
+                                   [&](int64_t const lo, int64_t const hi) { return (lo + n - 1) / n * n <= hi; });
+    }
+
+private:
+    friend class row_predicate<is_multiple_of_value>;
+
+    constexpr auto check(int64_t const x, std::span<uint8_t const>) const noexcept -> bool { return x % n == 0; }
+};
+
+
+// `product_of_digits_matches` with the product known only at run time.
+struct product_of_digits_matches_value : row_predicate<product_of_digits_matches_value>
+{
+    int64_t n{1};
+
+    constexpr explicit product_of_digits_matches_value(int64_t const product) noexcept
+        : n{product}
+    {}
+
+    constexpr auto allowed_digits() const noexcept -> std::bitset<10> { return digit_product::allowed_digits(n); }
+
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return digit_product::can_extend(n, prefix, remaining_len);
+    }
+
+private:
+    friend class row_predicate<product_of_digits_matches_value>;
+
+    constexpr auto check(int64_t const, std::span<uint8_t const> digits) const noexcept -> bool
+    {
+        return std::ranges::fold_left(digits, int64_t{1}, std::multiplies{}) == n;
+    }
+};
+
+
+// Any row clue, chosen at run time. Every call switches on the clue kind once and forwards to the matching predicate,
+// so puzzles read from files run without recompiling, at the cost of the inlining the compile-time predicates get.
+struct any_row_predicate
+{
+    enum class kind : uint8_t
+    {
+        perfect_square,
+        odd_palindrome,
+        fibonacci,
+        prime,
+        multiple_of,
+        product_of_digits,
+        divisible_by_its_digits,
+    };
+
+    kind    type{kind::perfect_square};
+    int64_t parameter{0};
+
+    constexpr bool operator==(any_row_predicate const&) const noexcept = default;
+
+    constexpr auto operator()(std::span<uint8_t const> digits) const noexcept -> std::tuple<bool, int64_t>
+    {
+        return visit_([&](auto const& pred) { return pred(digits); });
+    }
+
+    constexpr auto allowed_digits() const noexcept -> std::bitset<10>
+    {
+        return visit_([](auto const& pred) { return pred.allowed_digits(); });
+    }
+
+    constexpr void check_batch(row_batch const& batch, row_batch::lane_flags& out) const noexcept
+    {
+        visit_([&](auto const& pred) { pred.check_batch(batch, out); });
+    }
+
+    constexpr auto can_extend(std::span<uint8_t const> prefix, size_t const remaining_len) const noexcept -> bool
+    {
+        return visit_(
+            [&]<class Pred>(Pred const& pred)
+            {
+                if constexpr(CPrefixRowPredicate<Pred>)
+                    return pred.can_extend(prefix, remaining_len);
+                else
+                    return true;
+            });
+    }
+
+    // Parses a clue as written in puzzle files: the predicate name, followed by its parameter when it takes one.
+    static any_row_predicate parse(std::string_view const name, std::string_view const parameter = {})
+    {
+        for(auto const& [kind_name, kind_value, has_parameter]: kKinds)
+        {
+            if(name != kind_name)
+                continue;
+
+            if(has_parameter == parameter.empty())
+                throw std::invalid_argument{
+                    fmt::format("{} {}", name, has_parameter ? "needs a parameter" : "takes no parameter")};
+
+            any_row_predicate res{.type = kind_value};
+            if(has_parameter)
+            {
+                auto const* const last = parameter.data() + parameter.size();
+                auto const [ptr, ec]   = std::from_chars(parameter.data(), last, res.parameter);
+                if(ec != std::errc{} || ptr != last || res.parameter < 1)
+                    throw std::invalid_argument{fmt::format("invalid parameter '{}' for {}", parameter, name)};
+            }
+            return res;
+        }
+
+        throw std::invalid_argument{fmt::format("unknown predicate '{}'", name)};
+    }
+
+    // The clue a predicate stands for, a run-time clue being its own.
+    // clang-format off
+    static constexpr any_row_predicate of(any_row_predicate const& clue) noexcept { return clue; }
+    static constexpr any_row_predicate of(is_perfect_square) noexcept { return {kind::perfect_square}; }
+    static constexpr any_row_predicate of(is_odd_palindrome) noexcept { return {kind::odd_palindrome}; }
+    static constexpr any_row_predicate of(is_fibonacci) noexcept { return {kind::fibonacci}; }
+    static constexpr any_row_predicate of(is_prime) noexcept { return {kind::prime}; }
+    static constexpr any_row_predicate of(is_divisible_by_its_digits) noexcept { return {kind::divisible_by_its_digits}; }
+    template<int64_t N>
+    static constexpr any_row_predicate of(is_multiple_of<N>) noexcept { return {kind::multiple_of, N}; }
+    template<int64_t N>
+    static constexpr any_row_predicate of(product_of_digits_matches<N>) noexcept { return {kind::product_of_digits, N}; }
+    // clang-format on
+
+private:
+    struct kind_info
+    {
+        std::string_view name;
+        kind             value;
+        bool             has_parameter;
+    };
+
+    static constexpr auto kKinds = std::array<kind_info, 7>{{
+        {"is_perfect_square", kind::perfect_square, false},
+        {"is_odd_palindrome", kind::odd_palindrome, false},
+        {"is_fibonacci", kind::fibonacci, false},
+        {"is_prime", kind::prime, false},
+        {"is_multiple_of", kind::multiple_of, true},
+        {"product_of_digits_matches", kind::product_of_digits, true},
+        {"is_divisible_by_its_digits", kind::divisible_by_its_digits, false},
+    }};
+
+    // Dense switch, compiled to a jump table. Every predicate has to give `f` the same result type.
+    template<class F>
+    constexpr auto visit_(F&& f) const -> std::invoke_result_t<F, is_perfect_square const&>
+    {
+        switch(type)
+        {
+        case kind::perfect_square:
+            return f(is_perfect_square{});
+        case kind::odd_palindrome:
+            return f(is_odd_palindrome{});
+        case kind::fibonacci:
+            return f(is_fibonacci{});
+        case kind::prime:
+            return f(is_prime{});
+        case kind::multiple_of:
+            return f(is_multiple_of_value{parameter});
+        case kind::product_of_digits:
+            return f(product_of_digits_matches_value{parameter});
+        case kind::divisible_by_its_digits:
+            return f(is_divisible_by_its_digits{});
+        }
+        std::unreachable();
+    }
+};
+
+
+#endif // NUMBER_CROSS_RUNTIME_PRED_H
@@ -0,0 +1,199 @@
+#ifndef NUMBER_CROSS_STATS_H
+#define NUMBER_CROSS_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "spdlog/spdlog.h"
+
+// Build with -DNUMBER_CROSS_STATS=1 to count search events; otherwise the counters compile to nothing.
+#ifndef NUMBER_CROSS_STATS
+#define NUMBER_CROSS_STATS 0
+#endif
+
+
+// Search counters of `number_cross_grid_solver`. Rows map one to one to predicates, so per-row counts are per
+// predicate. Each worker of a parallel search keeps its own and they are merged once its work item is done.
+template<size_t N, bool Enabled = NUMBER_CROSS_STATS>
+class number_cross_stats
+{
+public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+
+    static constexpr bool kEnabled = true;
+
+    static constexpr auto kProgressInterval = std::chrono::seconds{10};
+
+    // clang-format off
+    constexpr void node(size_t const row) noexcept { ++nodes_[row]; }
+    constexpr void tile_tried(size_t const row) noexcept { ++tiles_[row]; }
+    constexpr void unique_collision() noexcept { ++unique_collisions_; }
+    constexpr void dead_end_hit(size_t const row) noexcept { ++dead_end_hits_[row]; }
+    // clang-format on
+
+    constexpr void partition_tried(size_t const row, bool const valid) noexcept
+    {
+        ++partitions_[row];
+        partitions_rejected_[row] += !valid;
+    }
+
+    constexpr void number_checked(size_t const row, bool const valid) noexcept
+    {
+        ++checks_[row];
+        checks_rejected_[row] += !valid;
+    }
+
+    constexpr void prefix_checked(size_t const row, bool const valid) noexcept
+    {
+        ++prefixes_[row];
+        prefixes_rejected_[row] += !valid;
+    }
+
+    void started() noexcept { start_ = last_report_ = clock::now(); }
+
+    time_point region_started() const noexcept { return clock::now(); }
+
+    void region_finished(time_point const started) noexcept
+    {
+        auto const elapsed = std::chrono::duration<double>(clock::now() - started).count();
+        ++regions_;
+        region_seconds_     += elapsed;
+        max_region_seconds_  = std::max(max_region_seconds_, elapsed);
+    }
+
+    // Logs the search progress at most once per `kProgressInterval`. `progress` is the fraction of the region search
+    // space handed out so far, computed only when a report is due.
+    template<class F>
+    void report_progress(F&& progress)
+    {
+        auto const now = clock::now();
+        if(now - last_report_ < kProgressInterval)
+            return;
+        last_report_ = now;
+
+        double const fraction = progress();
+        double const elapsed  = std::chrono::duration<double>(now - start_).count();
+        double const eta      = fraction > 0.0 ? elapsed * (1.0 - fraction) / fraction : 0.0;
+        SPDLOG_INFO("Progress: {:.3f}% of region configurations ({} searched) in {:.0f}s, ETA {:.0f}s",
+                    100.0 * fraction, regions_, elapsed, eta);
+    }
+
+    void merge(number_cross_stats const& other) noexcept
+    {
+        auto const add = [](auto& lhs, auto const& rhs)
+        { std::ranges::transform(lhs, rhs, lhs.begin(), std::plus<>{}); };
+        add(nodes_, other.nodes_);
+        add(tiles_, other.tiles_);
+        add(partitions_, other.partitions_);
+        add(partitions_rejected_, other.partitions_rejected_);
+        add(checks_, other.checks_);
+        add(checks_rejected_, other.checks_rejected_);
+        add(prefixes_, other.prefixes_);
+        add(prefixes_rejected_, other.prefixes_rejected_);
+        add(dead_end_hits_, other.dead_end_hits_);
+
+        unique_collisions_  += other.unique_collisions_;
+        regions_            += other.regions_;
+        region_seconds_     += other.region_seconds_;
+        max_region_seconds_  = std::max(max_region_seconds_, other.max_region_seconds_);
+    }
+
+    // Writes the counters as one line of JSON, tagged with `label`.
+    void dump(std::FILE* out, std::string_view const label) const
+    {
+        fmt::println(out,
+                     "{{\"label\": \"{}\", \"rows\": {}, \"nodes\": [{}], \"tiles\": [{}], \"partitions\": [{}], "
+                     "\"partitions_rejected\": [{}], \"number_checks\": [{}], \"number_checks_rejected\": [{}], "
+                     "\"prefix_checks\": [{}], \"prefix_checks_rejected\": [{}], \"dead_end_hits\": [{}], "
+                     "\"unique_collisions\": {}, \"region_configurations\": {}, \"region_seconds\": {:.6f}, "
+                     "\"max_region_seconds\": {:.6f}}}",
+                     escape_(label), N, fmt::join(nodes_, ", "), fmt::join(tiles_, ", "), fmt::join(partitions_, ", "),
+                     fmt::join(partitions_rejected_, ", "), fmt::join(checks_, ", "), fmt::join(checks_rejected_, ", "),
+                     fmt::join(prefixes_, ", "), fmt::join(prefixes_rejected_, ", "), fmt::join(dead_end_hits_, ", "),
+                     unique_collisions_, regions_, region_seconds_, max_region_seconds_);
+    }
+
+private:
+    using row_counters = std::array<uint64_t, N>;
+
+    // Escapes `text` for use inside a JSON string.
+    static std::string escape_(std::string_view const text)
+    {
+        std::string out;
+        out.reserve(text.size());
+        for(char const ch: text)
+        {
+            if(ch == '"' || ch == '\\')
+                out += '\\';
+            if(static_cast<unsigned char>(ch) < 0x20)
+                fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(ch));
+            else
+                out += ch;
+        }
+        return out;
+    }
+
+    row_counters nodes_{};
+    row_counters tiles_{};
+    row_counters partitions_{};
+    row_counters partitions_rejected_{};
+    row_counters checks_{};
+    row_counters checks_rejected_{};
+    row_counters prefixes_{};
+    row_counters prefixes_rejected_{};
+    row_counters dead_end_hits_{};
+
+    uint64_t unique_collisions_{0};
+    uint64_t regions_{0};
+    double   region_seconds_{0.0};
+    double   max_region_seconds_{0.0};
+
+    time_point start_{};
+    time_point last_report_{};
+};
+
+
+template<size_t N>
+class number_cross_stats<N, false>
+{
+public:
+    struct time_point
+    {};
+
+    static constexpr bool kEnabled = false;
+
+    // clang-format off
+    constexpr void node(size_t) noexcept {}
+    constexpr void tile_tried(size_t) noexcept {}
+    constexpr void unique_collision() noexcept {}
+    constexpr void dead_end_hit(size_t) noexcept {}
+    constexpr void partition_tried(size_t, bool) noexcept {}
+    constexpr void number_checked(size_t, bool) noexcept {}
+    constexpr void prefix_checked(size_t, bool) noexcept {}
+    constexpr void started() noexcept {}
+    constexpr time_point region_started() const noexcept { return {}; }
+    constexpr void region_finished(time_point) noexcept {}
+    template<class F>
+    constexpr void report_progress(F&&) noexcept {}
+    constexpr void merge(number_cross_stats const&) noexcept {}
+    // clang-format on
+
+    void dump(std::FILE*, std::string_view) const
+    {
+        SPDLOG_WARN("Statistics are disabled, build with NUMBER_CROSS_STATS=1");
+    }
+};
+
+
+#endif // NUMBER_CROSS_STATS_H
@@ -10,6 +10,7 @@ endif()
 include(FetchContent)
 
 set(BUILD_SHARED_LIBS ON)
+set(TBB_TEST OFF CACHE BOOL "" FORCE)
 FetchContent_Declare(tbb
     GIT_REPOSITORY https://github.com/uxlfoundation/oneTBB
     GIT_TAG ${tbb_FETCH_VERSION}